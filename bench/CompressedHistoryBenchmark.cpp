@@ -0,0 +1,66 @@
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+
+#include "../lib/CCircularBuffer.h"
+#include "../lib/CCompressedHistory.h"
+
+// Memory per value and sequential decode throughput of CCompressedHistory
+// against a plain CCircularBuffer<int64_t> holding the same timestamp series.
+
+const size_t kValues = 4'000'000;
+const int kPasses = 10;
+
+template <typename Container>
+double scan(const Container& container, uint64_t& checksum) {
+    auto start = std::chrono::steady_clock::now();
+
+    for (int pass = 0; pass < kPasses; pass++) {
+        for (auto it = container.begin(); it != container.end(); ++it) {
+            checksum += static_cast<uint64_t>(*it);
+        }
+    }
+
+    auto finish = std::chrono::steady_clock::now();
+    double seconds = std::chrono::duration<double>(finish - start).count();
+
+    return static_cast<double>(container.size()) * kPasses / seconds / 1e6;
+}
+
+int main() {
+    CCircularBuffer<int64_t> plain(kValues);
+    CCompressedHistory<int64_t> compressed(kValues * 2);
+
+    int64_t time = 1'700'000'000'000'000;
+    uint64_t state = 1;
+
+    for (size_t i = 0; i < kValues; i++) {
+        state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+        time += 1000 + static_cast<int64_t>(state >> 56);
+        plain.push_back(time);
+        compressed.push_back(time);
+    }
+
+    uint64_t checksum = 0;
+    double plain_rate = scan(plain, checksum);
+    double compressed_rate = scan(compressed, checksum);
+
+    auto per_value = [](size_t bytes, size_t values) {
+        return static_cast<double>(bytes) / static_cast<double>(values);
+    };
+
+    // data: encoded bytes held; index: block descriptors; total: everything
+    // the container allocated, which is what "more history in the same
+    // memory" has to be judged by.
+    std::printf("%-12s %12s %12s %12s %16s\n", "container", "data B/val", "index B/val", "total B/val", "decode Mvalues/s");
+    std::printf("%-12s %12.2f %12.2f %12.2f %16.1f\n", "plain", per_value(sizeof(int64_t), 1), 0.0,
+                per_value((plain.max_size() + 1) * sizeof(int64_t), plain.size()), plain_rate);
+    std::printf("%-12s %12.2f %12.2f %12.2f %16.1f\n", "compressed",
+                per_value(compressed.bytes_used(), compressed.size()),
+                per_value(compressed.index_bytes(), compressed.size()),
+                per_value(compressed.memory_used(), compressed.size()), compressed_rate);
+    std::printf("values kept: plain %zu, compressed %zu (checksum %llu)\n",
+                plain.size(), compressed.size(), static_cast<unsigned long long>(checksum));
+
+    return 0;
+}
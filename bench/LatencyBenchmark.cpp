@@ -0,0 +1,244 @@
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <thread>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+#include "../lib/CBroadcastBuffer.h"
+#include "../lib/CCircularBuffer.h"
+#include "../lib/CCircularBufferExp.h"
+#include "../lib/CConcurrentBufferExp.h"
+#include "LatencyHistogram.h"
+
+// Per-operation latency of push and pop for each buffer variant with one
+// producer and one consumer thread pinned to the given cores. Every call is
+// timestamped individually and recorded into a log-bucketed histogram, so
+// the tail (growth, allocator calls, cache-line transfers) shows up instead
+// of being averaged away.
+//
+// Usage: latency_benchmark [operations] [producer_core] [consumer_core]
+
+const size_t kCapacity = 1 << 12;
+
+// Time source: rdtsc on x86, steady_clock elsewhere. Ticks are converted to
+// nanoseconds with a ratio measured at startup.
+struct Clock {
+    static uint64_t now() {
+#if defined(__x86_64__) || defined(__i386__)
+        return __rdtsc();
+#else
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+    }
+
+    static double nanosecondsPerTick() {
+        auto start_time = std::chrono::steady_clock::now();
+        uint64_t start_ticks = now();
+
+        while (std::chrono::steady_clock::now() - start_time < std::chrono::milliseconds(100)) {}
+
+        double nanoseconds = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start_time).count();
+        return nanoseconds / static_cast<double>(now() - start_ticks);
+    }
+};
+
+void pin(int core) {
+#ifdef __linux__
+    if (core < 0) {
+        return;
+    }
+
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(core, &set);
+
+    if (pthread_setaffinity_np(pthread_self(), sizeof(set), &set) != 0) {
+        std::fprintf(stderr, "warning: cannot pin thread to core %d\n", core);
+    }
+#endif
+}
+
+// Every variant bounds how far the producer may run ahead (outside the
+// timed region): fixed rings so they never overwrite, growable ones so they
+// grow from a small start a dozen times but stay bounded.
+template <typename Buffer, size_t Capacity, size_t Limit>
+struct Locked {
+    static constexpr size_t kLimit = Limit;
+
+    std::mutex mutex;
+    Buffer buffer{Capacity};
+
+    void push(uint64_t value) {
+        std::lock_guard<std::mutex> lock(mutex);
+        buffer.push_back(value);
+    }
+
+    bool pop(uint64_t& value) {
+        std::lock_guard<std::mutex> lock(mutex);
+
+        if (buffer.empty()) {
+            return false;
+        }
+
+        value = buffer[0];
+        buffer.pop_front();
+        return true;
+    }
+
+    size_t size() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return buffer.size();
+    }
+};
+
+struct Broadcast {
+    static constexpr size_t kLimit = kCapacity;
+
+    CBroadcastBuffer<uint64_t> buffer{kCapacity, 1};
+
+    void push(uint64_t value) {
+        buffer.push_back(value);
+    }
+
+    bool pop(uint64_t& value) {
+        return buffer.consume(0, 1, [&](uint64_t element) { value = element; }) != 0;
+    }
+
+    size_t size() {
+        return buffer.available(0);
+    }
+};
+
+// Single writer: the consumer reads through a guard and the producer pops
+// what has been read, as in a writer-owned log with concurrent readers.
+// Values are pushed as 0, 1, 2, ..., so the first value in a guard is the
+// sequence of its head.
+struct ConcurrentExp {
+    static constexpr size_t kLimit = 1 << 16;
+
+    CConcurrentBufferExp<uint64_t> buffer{16, 1};
+    std::atomic<uint64_t> read = 0;
+    uint64_t popped = 0;
+
+    void push(uint64_t value) {
+        for (uint64_t done = read.load(std::memory_order_acquire); popped < done; popped++) {
+            buffer.pop_front();
+        }
+
+        buffer.push_back(value);
+    }
+
+    bool pop(uint64_t& value) {
+        auto guard = buffer.read(0);
+        uint64_t next = read.load(std::memory_order_relaxed);
+
+        if (guard.empty() || next - guard[0] >= guard.size()) {
+            return false;
+        }
+
+        value = guard[next - guard[0]];
+        read.store(next + 1, std::memory_order_release);
+        return true;
+    }
+
+    size_t size() {
+        return buffer.size();
+    }
+};
+
+struct Result {
+    LatencyHistogram push;
+    LatencyHistogram pop;
+};
+
+template <typename Variant>
+void run(Variant& variant, size_t operations, int producer_core, int consumer_core, Result& result) {
+    std::thread consumer([&]() {
+        pin(consumer_core);
+        uint64_t value = 0;
+        size_t received = 0;
+
+        while (received != operations) {
+            uint64_t start = Clock::now();
+            bool popped = variant.pop(value);
+            uint64_t finish = Clock::now();
+
+            if (popped) {
+                result.pop.record(finish - start);
+                received++;
+            } else {
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    pin(producer_core);
+
+    for (size_t i = 0; i < operations; i++) {
+        while (variant.size() >= Variant::kLimit) {
+            std::this_thread::yield();
+        }
+
+        uint64_t start = Clock::now();
+        variant.push(i);
+        uint64_t finish = Clock::now();
+
+        result.push.record(finish - start);
+    }
+
+    consumer.join();
+}
+
+void print(const char* name, const char* operation, const LatencyHistogram& histogram, double scale) {
+    auto ns = [&](uint64_t ticks) { return static_cast<double>(ticks) * scale; };
+
+    std::printf("%-22s %-5s %10llu %9.0f %9.0f %9.0f %11.0f\n", name, operation,
+                static_cast<unsigned long long>(histogram.count()),
+                ns(histogram.percentile(50)), ns(histogram.percentile(99)),
+                ns(histogram.percentile(99.9)), ns(histogram.max()));
+}
+
+template <typename Variant>
+void measure(const char* name, size_t operations, int producer_core, int consumer_core, double scale) {
+    auto* variant = new Variant();
+    auto* result = new Result();
+
+    run(*variant, operations, producer_core, consumer_core, *result);
+    print(name, "push", result->push, scale);
+    print(name, "pop", result->pop, scale);
+
+    delete result;
+    delete variant;
+}
+
+int main(int argc, char** argv) {
+    size_t operations = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1'000'000;
+    unsigned cores = std::thread::hardware_concurrency();
+    int producer_core = argc > 2 ? std::atoi(argv[2]) : (cores > 1 ? 0 : -1);
+    int consumer_core = argc > 3 ? std::atoi(argv[3]) : (cores > 1 ? 1 : -1);
+
+    double scale = Clock::nanosecondsPerTick();
+
+    std::printf("operations %zu, producer core %d, consumer core %d, latencies in ns\n",
+                operations, producer_core, consumer_core);
+    std::printf("%-22s %-5s %10s %9s %9s %9s %11s\n", "variant", "op", "count", "p50", "p99", "p99.9", "max");
+
+    measure<Locked<CCircularBuffer<uint64_t>, kCapacity, kCapacity>>("CCircularBuffer+mutex", operations, producer_core, consumer_core, scale);
+    measure<Locked<CCircularBufferExp<uint64_t>, 16, 1 << 16>>("CCircularBufferExp+mut", operations, producer_core, consumer_core, scale);
+    measure<Broadcast>("CBroadcastBuffer", operations, producer_core, consumer_core, scale);
+    measure<ConcurrentExp>("CConcurrentBufferExp", operations, producer_core, consumer_core, scale);
+
+    return 0;
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <bit>
+#include <cstdint>
+#include <cstdio>
+
+// HDR-style histogram: values below 2 * kSubBuckets are counted exactly,
+// larger ones in kSubBuckets log-spaced buckets per power of two, which
+// keeps every recorded value within 1 / kSubBuckets of its true size.
+class LatencyHistogram {
+    static constexpr int kSubBits = 6;
+    static constexpr uint64_t kSubBuckets = uint64_t(1) << kSubBits;
+    static constexpr size_t kBuckets = (64 - kSubBits) * kSubBuckets + 2 * kSubBuckets;
+
+    uint64_t counts_[kBuckets] = {};
+    uint64_t total_ = 0;
+    uint64_t max_ = 0;
+
+    static size_t index(uint64_t value) {
+        if (value < 2 * kSubBuckets) {
+            return value;
+        }
+
+        int exponent = std::bit_width(value) - kSubBits - 1;
+        return exponent * kSubBuckets + (value >> exponent);
+    }
+
+    // Largest value that falls into bucket.
+    static uint64_t highest(size_t bucket) {
+        if (bucket < 2 * kSubBuckets) {
+            return bucket;
+        }
+
+        int exponent = static_cast<int>(bucket / kSubBuckets) - 1;
+        uint64_t sub = bucket % kSubBuckets + kSubBuckets;
+
+        return ((sub + 1) << exponent) - 1;
+    }
+
+public:
+    void record(uint64_t value) {
+        counts_[index(value)]++;
+        total_++;
+
+        if (value > max_) {
+            max_ = value;
+        }
+    }
+
+    [[nodiscard]] uint64_t percentile(double percent) const {
+        auto rank = static_cast<uint64_t>(percent / 100.0 * static_cast<double>(total_) + 0.5);
+        uint64_t seen = 0;
+
+        if (rank == 0) {
+            rank = 1;
+        }
+
+        for (size_t i = 0; i < kBuckets; i++) {
+            seen += counts_[i];
+
+            if (seen >= rank) {
+                return highest(i) < max_ ? highest(i) : max_;
+            }
+        }
+
+        return max_;
+    }
+
+    [[nodiscard]] uint64_t count() const {
+        return total_;
+    }
+
+    [[nodiscard]] uint64_t max() const {
+        return max_;
+    }
+};
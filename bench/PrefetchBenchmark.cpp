@@ -0,0 +1,119 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <numeric>
+#include <random>
+#include <vector>
+
+#include "../lib/CCircularBuffer.h"
+
+// Drain throughput of a CCircularBuffer of pointers to nodes scattered over
+// a pool much larger than the last-level cache, so every element is a cache
+// miss on the node it points to. Compares draining through Iterator and
+// pop_front with consume_batch, with and without prefetching the nodes.
+//
+// Usage: prefetch_benchmark [distance] [nodes]
+
+const size_t kCapacity = 1 << 16;
+const size_t kBatch = 256;
+const int kPasses = 4;
+
+struct Node {
+    uint64_t key;
+    uint64_t payload[7];
+};
+
+// Per-node work, enough of it that the out-of-order window alone cannot
+// reach the misses of the following nodes.
+uint64_t visit(const Node* node, uint64_t sum) {
+    for (uint64_t word : node->payload) {
+        sum = (sum ^ word ^ node->key) * 0x9e3779b97f4a7c15ULL;
+        sum ^= sum >> 29;
+    }
+
+    return sum;
+}
+
+template <typename Drain>
+double measure(CCircularBuffer<Node*>& buffer, const std::vector<Node*>& order, Drain drain, uint64_t& checksum) {
+    std::chrono::duration<double> elapsed{};
+
+    for (int pass = 0; pass < kPasses; pass++) {
+        for (size_t offset = 0; offset < order.size(); offset += kCapacity) {
+            for (size_t i = offset; i < offset + kCapacity; i++) {
+                buffer.push_back(order[i]);
+            }
+
+            auto start = std::chrono::steady_clock::now();
+            checksum += drain(buffer);
+            elapsed += std::chrono::steady_clock::now() - start;
+        }
+    }
+
+    return static_cast<double>(order.size()) * kPasses / elapsed.count() / 1e6;
+}
+
+int main(int argc, char** argv) {
+    size_t distance = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : CCircularBuffer<Node*>::kPrefetchDistance;
+    size_t nodes = argc > 2 ? std::strtoull(argv[2], nullptr, 10) / kCapacity * kCapacity : size_t(1) << 23;
+
+    if (nodes == 0) {
+        std::fprintf(stderr, "nodes must be at least %zu\n", kCapacity);
+        return 1;
+    }
+
+    std::vector<Node> pool(nodes);
+    std::vector<Node*> order(nodes);
+    for (size_t i = 0; i < nodes; i++) {
+        pool[i].key = i;
+        order[i] = &pool[i];
+    }
+    std::shuffle(order.begin(), order.end(), std::mt19937_64(42));
+
+    CCircularBuffer<Node*> buffer(kCapacity);
+    uint64_t checksum = 0;
+
+    double iterator_rate = measure(buffer, order, [](CCircularBuffer<Node*>& buffer) {
+        uint64_t sum = 0;
+
+        while (!buffer.empty()) {
+            sum = visit(*buffer.begin(), sum);
+            buffer.pop_front();
+        }
+
+        return sum;
+    }, checksum);
+
+    auto batched = [&](size_t prefetch_distance, bool project) {
+        return [=](CCircularBuffer<Node*>& buffer) {
+            uint64_t sum = 0;
+            auto callback = [&](Node* node) { sum = visit(node, sum); };
+
+            while (!buffer.empty()) {
+                if (project) {
+                    buffer.consume_batch(kBatch, callback, prefetch_distance, [](Node* node) { return node; });
+                } else {
+                    buffer.consume_batch(kBatch, callback, prefetch_distance);
+                }
+            }
+
+            return sum;
+        };
+    };
+
+    double batch_rate = measure(buffer, order, batched(0, false), checksum);
+    double slot_rate = measure(buffer, order, batched(distance, false), checksum);
+    double node_rate = measure(buffer, order, batched(distance, true), checksum);
+
+    std::printf("nodes %zu, batch %zu, prefetch distance %zu\n", nodes, kBatch, distance);
+    std::printf("%-32s %14s\n", "drain", "Melements/s");
+    std::printf("%-32s %14.1f\n", "Iterator + pop_front", iterator_rate);
+    std::printf("%-32s %14.1f\n", "consume_batch, no prefetch", batch_rate);
+    std::printf("%-32s %14.1f\n", "consume_batch, slot prefetch", slot_rate);
+    std::printf("%-32s %14.1f\n", "consume_batch, node prefetch", node_rate);
+    std::printf("checksum %llu\n", static_cast<unsigned long long>(checksum));
+
+    return 0;
+}
@@ -0,0 +1,96 @@
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "../lib/CCircularBuffer.h"
+#include "../lib/CShardedBuffer.h"
+
+// Producer throughput of one mutex-protected CCircularBuffer against
+// CShardedBuffer with one shard per producer, while a single consumer drains.
+
+const size_t kItemsPerProducer = 2'000'000;
+const size_t kCapacity = 1 << 16;
+const size_t kBatch = 4096;
+
+struct SingleRing {
+    std::mutex mutex;
+    CCircularBuffer<size_t> buffer{kCapacity};
+
+    void push_back(size_t, size_t value) {
+        std::lock_guard<std::mutex> lock(mutex);
+        buffer.push_back(value);
+    }
+
+    template <typename Callback>
+    size_t drain(size_t batch, Callback callback) {
+        std::lock_guard<std::mutex> lock(mutex);
+        size_t count = 0;
+
+        while (!buffer.empty() && count < batch) {
+            callback(buffer[0]);
+            buffer.pop_front();
+            count++;
+        }
+
+        return count;
+    }
+};
+
+template <typename Ring>
+double run(Ring& ring, size_t producers) {
+    std::atomic<bool> done = false;
+    std::atomic<size_t> sink = 0;
+
+    std::thread consumer([&]() {
+        size_t sum = 0;
+        auto callback = [&](size_t value) { sum += value; };
+
+        while (!done.load(std::memory_order_acquire)) {
+            ring.drain(kBatch, callback);
+        }
+        while (ring.drain(kBatch, callback) != 0) {}
+
+        sink = sum;
+    });
+
+    auto start = std::chrono::steady_clock::now();
+
+    std::vector<std::thread> threads;
+    for (size_t p = 0; p < producers; p++) {
+        threads.emplace_back([&ring, p]() {
+            for (size_t i = 0; i < kItemsPerProducer; i++) {
+                ring.push_back(p, i);
+            }
+        });
+    }
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    auto finish = std::chrono::steady_clock::now();
+    done.store(true, std::memory_order_release);
+    consumer.join();
+
+    double seconds = std::chrono::duration<double>(finish - start).count();
+    return static_cast<double>(producers * kItemsPerProducer) / seconds / 1e6;
+}
+
+int main() {
+    std::printf("%-10s %16s %16s\n", "producers", "single Mops/s", "sharded Mops/s");
+
+    for (size_t producers = 1; producers <= std::max(4u, std::thread::hardware_concurrency()); producers *= 2) {
+        SingleRing single;
+        CShardedBuffer<size_t> sharded(kCapacity, producers);
+
+        double single_rate = run(single, producers);
+        double sharded_rate = run(sharded, producers);
+
+        std::printf("%-10zu %16.2f %16.2f\n", producers, single_rate, sharded_rate);
+    }
+
+    return 0;
+}
@@ -0,0 +1,300 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+
+// What the writer of a CBroadcastBuffer does when the slowest reader is a
+// whole capacity behind.
+enum class CBroadcastMode {
+    // Wait (push_back) or fail (try_push) until that reader releases.
+    Gate,
+    // Overwrite the oldest slot; the lapped reader skips ahead and counts the
+    // elements it missed.
+    Overwrite
+};
+
+// Single-writer, multi-reader broadcast ring in the style of the LMAX
+// Disruptor: every reader sees every element and keeps its own sequence
+// cursor, so one buffer replaces a copy per consumer. Sequences are 64-bit
+// and never wrap; the slot of a sequence is sequence % capacity.
+//
+// Readers are numbered 0 .. reader_count - 1 and each must be driven by one
+// thread. They take available ranges in batches with claim/release or with
+// consume. In Overwrite mode an element can be overwritten while it is read,
+// so T must be trivially copyable, slots are copied word by word through
+// relaxed std::atomic_ref, and every read is validated afterwards, seqlock
+// style.
+template <typename T, CBroadcastMode Mode = CBroadcastMode::Gate>
+class CBroadcastBuffer {
+    static_assert(Mode == CBroadcastMode::Gate || std::is_trivially_copyable_v<T>,
+                  "CBroadcastMode::Overwrite needs a trivially copyable T");
+
+    static constexpr bool kOverwrite = Mode == CBroadcastMode::Overwrite;
+
+    struct alignas(64) Cursor {
+        std::atomic<uint64_t> sequence = 0;
+        uint64_t lost = 0;
+    };
+
+    struct Words {
+        uint64_t word[(sizeof(T) + sizeof(uint64_t) - 1) / sizeof(uint64_t)];
+    };
+
+    using Slot = std::conditional_t<kOverwrite, Words, T>;
+
+    Slot* buffer_;
+    size_t capacity_;
+    Cursor* readers_;
+    size_t reader_count_;
+
+    // Writer only.
+    alignas(64) uint64_t next_ = 0;
+    uint64_t cached_min_ = 0;
+
+    // Sequence up to which the writer has started writing (Overwrite mode)
+    // and up to which elements are complete.
+    alignas(64) std::atomic<uint64_t> claimed_ = 0;
+    alignas(64) std::atomic<uint64_t> published_ = 0;
+
+    [[nodiscard]] uint64_t slowestReader() const {
+        uint64_t result = next_;
+
+        for (size_t i = 0; i < reader_count_; i++) {
+            result = std::min(result, readers_[i].sequence.load(std::memory_order_acquire));
+        }
+
+        return result;
+    }
+
+    // Number of elements the writer may add without passing a reader.
+    size_t writable(size_t wanted) {
+        if constexpr (kOverwrite) {
+            return wanted;
+        }
+
+        if (next_ + wanted - cached_min_ > capacity_) {
+            cached_min_ = slowestReader();
+        }
+
+        return std::min<uint64_t>(wanted, capacity_ - (next_ - cached_min_));
+    }
+
+    static void store(Slot& slot, const T& value) {
+        if constexpr (kOverwrite) {
+            Words words{};
+            std::memcpy(words.word, &value, sizeof(T));
+
+            for (size_t i = 0; i < std::size(words.word); i++) {
+                std::atomic_ref<uint64_t>(slot.word[i]).store(words.word[i], std::memory_order_relaxed);
+            }
+        } else {
+            slot = value;
+        }
+    }
+
+    static T load(Slot& slot) requires kOverwrite {
+        Words words;
+        T value;
+
+        for (size_t i = 0; i < std::size(words.word); i++) {
+            words.word[i] = std::atomic_ref<uint64_t>(slot.word[i]).load(std::memory_order_relaxed);
+        }
+
+        std::memcpy(&value, words.word, sizeof(T));
+        return value;
+    }
+
+    void write(const T* values, size_t count) {
+        if constexpr (kOverwrite) {
+            claimed_.store(next_ + count, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+        }
+
+        for (size_t i = 0; i < count; i++) {
+            store(buffer_[(next_ + i) % capacity_], values[i]);
+        }
+
+        next_ += count;
+        published_.store(next_, std::memory_order_release);
+    }
+
+    // How many of the sequences [begin, end) the writer may have
+    // overwritten by now, after they were read.
+    [[nodiscard]] uint64_t overwritten(uint64_t begin, uint64_t end) const {
+        if constexpr (kOverwrite) {
+            std::atomic_thread_fence(std::memory_order_acquire);
+            uint64_t claimed = claimed_.load(std::memory_order_relaxed);
+
+            if (claimed <= begin + capacity_) {
+                return 0;
+            }
+
+            return std::min(claimed - capacity_ - begin, end - begin);
+        }
+
+        return 0;
+    }
+
+    Cursor& reader(size_t reader) {
+        if (reader >= reader_count_) {
+            throw std::out_of_range("In CBroadcastBuffer reader is out of range");
+        }
+
+        return readers_[reader];
+    }
+
+public:
+    // Sequences [begin, end) available to a reader; lost is the number of
+    // elements it missed because the writer lapped it (Overwrite mode only).
+    struct Range {
+        uint64_t begin;
+        uint64_t end;
+        uint64_t lost;
+
+        [[nodiscard]] size_t size() const {
+            return end - begin;
+        }
+
+        [[nodiscard]] bool empty() const {
+            return begin == end;
+        }
+    };
+
+    CBroadcastBuffer(size_t buffer_size, size_t reader_count) {
+        if (buffer_size == 0) {
+            throw std::invalid_argument("CBroadcastBuffer capacity must be positive");
+        }
+
+        capacity_ = buffer_size;
+        buffer_ = new Slot[capacity_];
+        reader_count_ = reader_count;
+        readers_ = new Cursor[reader_count_];
+    }
+
+    ~CBroadcastBuffer() {
+        delete[] buffer_;
+        delete[] readers_;
+    }
+
+    CBroadcastBuffer(const CBroadcastBuffer& other) = delete;
+    CBroadcastBuffer& operator= (const CBroadcastBuffer& other) = delete;
+
+    bool try_push(const T& value) {
+        if (writable(1) == 0) {
+            return false;
+        }
+
+        write(&value, 1);
+        return true;
+    }
+
+    // Writes as many of values as fit and publishes them at once. Returns
+    // the number written.
+    size_t try_push(const T* values, size_t count) {
+        count = writable(count);
+        write(values, count);
+        return count;
+    }
+
+    void push_back(const T& value) {
+        while (!try_push(value)) {
+            std::this_thread::yield();
+        }
+    }
+
+    Range claim(size_t reader, size_t max_count = SIZE_MAX) {
+        Cursor& cursor = this->reader(reader);
+        uint64_t begin = cursor.sequence.load(std::memory_order_relaxed);
+        uint64_t end = published_.load(std::memory_order_acquire);
+        uint64_t lost = 0;
+
+        if (kOverwrite && end - begin > capacity_) {
+            lost = end - capacity_ - begin;
+            begin = end - capacity_;
+            cursor.lost += lost;
+            cursor.sequence.store(begin, std::memory_order_relaxed);
+        }
+
+        return {begin, begin + std::min<uint64_t>(end - begin, max_count), lost};
+    }
+
+    // Element of a claimed sequence. In Overwrite mode it is returned as a
+    // copy, which is only valid if release of its range returns true.
+    std::conditional_t<kOverwrite, T, const T&> operator[] (uint64_t sequence) const {
+        if constexpr (kOverwrite) {
+            return load(buffer_[sequence % capacity_]);
+        } else {
+            return buffer_[sequence % capacity_];
+        }
+    }
+
+    // Marks range as consumed. Returns false if the writer may have
+    // overwritten part of it while it was being read; those elements are
+    // counted as lost, as consume does.
+    bool release(size_t reader, const Range& range) {
+        Cursor& cursor = this->reader(reader);
+        uint64_t lost = overwritten(range.begin, range.end);
+
+        cursor.lost += lost;
+        cursor.sequence.store(range.end, std::memory_order_release);
+
+        return lost == 0;
+    }
+
+    // Claims up to max_count elements, passes each to callback and releases
+    // them. In Overwrite mode every element is copied and validated first;
+    // the ones overwritten meanwhile are skipped and counted as lost.
+    template <typename Callback>
+    size_t consume(size_t reader, size_t max_count, Callback callback) {
+        Range range = claim(reader, max_count);
+        size_t count = 0;
+
+        for (uint64_t sequence = range.begin; sequence != range.end; sequence++) {
+            if constexpr (kOverwrite) {
+                T value = (*this)[sequence];
+
+                if (overwritten(sequence, sequence + 1) != 0) {
+                    readers_[reader].lost++;
+                    continue;
+                }
+
+                callback(value);
+            } else {
+                callback((*this)[sequence]);
+            }
+
+            count++;
+        }
+
+        readers_[reader].sequence.store(range.end, std::memory_order_release);
+        return count;
+    }
+
+    // Elements published but not yet released by reader.
+    [[nodiscard]] size_t available(size_t reader) {
+        return published_.load(std::memory_order_acquire) - this->reader(reader).sequence.load(std::memory_order_relaxed);
+    }
+
+    // Elements reader has missed so far (Overwrite mode).
+    [[nodiscard]] uint64_t lost(size_t reader) {
+        return this->reader(reader).lost;
+    }
+
+    [[nodiscard]] uint64_t published() const {
+        return published_.load(std::memory_order_acquire);
+    }
+
+    [[nodiscard]] size_t max_size() const {
+        return capacity_;
+    }
+
+    [[nodiscard]] size_t reader_count() const {
+        return reader_count_;
+    }
+};
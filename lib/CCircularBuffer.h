@@ -1,15 +1,98 @@
 #pragma once
 
+#include <algorithm>
 #include <iostream>
+#include <memory>
+#include <span>
+#include <type_traits>
+
+// Allocation of slot arrays shared by the circular buffers. Slots are
+// constructed only when T needs it or during constant evaluation, where
+// copying or shifting through slots that were never written is an error.
+// Large trivial buffers are then never touched here, leaving page placement
+// to the allocator.
+template <typename T, typename Allocator>
+struct CSlotStorage {
+    using AllocatorTraits = std::allocator_traits<Allocator>;
+
+    static constexpr T* allocate(Allocator& allocator, size_t count) {
+        T* storage = AllocatorTraits::allocate(allocator, count);
+
+        if (std::is_constant_evaluated() || !std::is_trivially_default_constructible_v<T>) {
+            for (size_t i = 0; i < count; i++) {
+                AllocatorTraits::construct(allocator, storage + i);
+            }
+        }
 
-template <typename T>
+        return storage;
+    }
+
+    static constexpr void deallocate(Allocator& allocator, T* storage, size_t count) {
+        if (storage == nullptr) {
+            return;
+        }
+
+        for (size_t i = 0; i < count; i++) {
+            AllocatorTraits::destroy(allocator, storage + i);
+        }
+
+        AllocatorTraits::deallocate(allocator, storage, count);
+    }
+};
+
+template <typename T, typename Allocator = std::allocator<T>>
 class CCircularBuffer {
+public:
+    // Default projection of consume_batch: prefetch the slots only.
+    struct NoProjection {};
+
+    static constexpr size_t kPrefetchDistance = 8;
+
 protected:
+    using AllocatorTraits = std::allocator_traits<Allocator>;
+
     T* buffer_;
     size_t size_;
     size_t begin_;
     size_t end_;
     size_t capacity_;
+    Allocator allocator_;
+
+    constexpr T* allocate(size_t count) {
+        return CSlotStorage<T, Allocator>::allocate(allocator_, count);
+    }
+
+    constexpr void deallocate(T* storage, size_t count) {
+        CSlotStorage<T, Allocator>::deallocate(allocator_, storage, count);
+    }
+
+    // Gries-Mills rotation of [first, last) so that middle becomes first:
+    // repeatedly swaps the shorter block into its final place, which for
+    // trivially copyable types is a sequence of vectorizable swap_ranges.
+    static constexpr void blockSwapRotate(T* first, T* middle, T* last) {
+        size_t left = middle - first;
+        size_t right = last - middle;
+
+        while (left != 0 && right != 0) {
+            if (left <= right) {
+                std::swap_ranges(first, first + left, first + left);
+                first += left;
+                right -= left;
+            } else {
+                std::swap_ranges(first, first + right, first + left);
+                first += right;
+                left -= right;
+            }
+        }
+    }
+
+    static constexpr void prefetch([[maybe_unused]] const void* address) {
+#if defined(__GNUC__) || defined(__clang__)
+        if !consteval {
+            __builtin_prefetch(address);
+        }
+#endif
+    }
 
 public:
     class Iterator {
@@ -19,7 +102,7 @@ public:
         size_t index_;
         size_t begin_;
 
-        [[nodiscard]] size_t getIndex() const {
+        [[nodiscard]] constexpr size_t getIndex() const {
             return (begin_ + index_) % (capacity_ + 1);
         }
     public:
@@ -29,133 +112,141 @@ public:
         using pointer = T*;
         using reference = T&;
 
-        Iterator(T* buffer, size_t capacity, size_t index, size_t begin)
+        constexpr Iterator(T* buffer, size_t capacity, size_t index, size_t begin)
                 : buffer_(buffer), capacity_(capacity), index_(index), begin_(begin) {};
 
-        reference operator[](size_t num) {
+        constexpr reference operator[](size_t num) {
             return buffer_[(begin_ + index_ + num) % (capacity_ + 1)];
         }
 
-        reference operator*() {
+        constexpr reference operator*() {
             return buffer_[getIndex()];
         }
 
-        pointer operator->() {
+        constexpr pointer operator->() {
             return buffer_ + getIndex();
         }
 
-        Iterator& operator++() {
+        constexpr Iterator& operator++() {
             index_++;
             return *this;
         }
 
-        Iterator& operator--() {
+        constexpr Iterator& operator--() {
             index_--;
             return *this;
         }
 
-        bool operator== (const Iterator& other) const {
+        constexpr bool operator== (const Iterator& other) const {
             return getIndex() == other.getIndex();
         }
 
-        bool operator!= (const Iterator& other) const {
+        constexpr bool operator!= (const Iterator& other) const {
             return getIndex() != other.getIndex();
         }
 
-        bool operator<= (const Iterator& other) const {
+        constexpr bool operator<= (const Iterator& other) const {
             return getIndex() <= other.getIndex();
         }
 
-        bool operator< (const Iterator& other) const {
+        constexpr bool operator< (const Iterator& other) const {
             return getIndex() < other.getIndex();
         }
 
-        bool operator>= (const Iterator& other) const {
+        constexpr bool operator>= (const Iterator& other) const {
             return getIndex() >= other.getIndex();
         }
 
-        bool operator> (const Iterator& other) const {
+        constexpr bool operator> (const Iterator& other) const {
             return getIndex() > other.getIndex();
         }
 
-        Iterator& operator+= (difference_type num) {
+        constexpr Iterator& operator+= (difference_type num) {
             index_ += num;
             return *this;
         }
 
-        Iterator operator+ (difference_type num) const {
+        constexpr Iterator operator+ (difference_type num) const {
             Iterator iterator = *this;
             iterator += num;
             return iterator;
         }
 
-        Iterator& operator-= (difference_type num) {
+        constexpr Iterator& operator-= (difference_type num) {
             index_ -= num;
             return *this;
         }
 
-        Iterator operator- (difference_type num) const {
+        constexpr Iterator operator- (difference_type num) const {
             Iterator iterator = *this;
             iterator -= num;
             return iterator;
         }
 
-        difference_type operator- (const Iterator& other) const {
+        constexpr difference_type operator- (const Iterator& other) const {
             return (index_ % (capacity_ + 1)) - (other.index_ % (other.capacity_ + 1));
         }
     };
 
-    CCircularBuffer() {
+    constexpr explicit CCircularBuffer(const Allocator& allocator = Allocator()) : allocator_(allocator) {
         size_ = 0;
         begin_ = end_ = 0;
         capacity_ = 0;
         buffer_ = nullptr;
     }
 
-    explicit CCircularBuffer(size_t buffer_size) {
+    constexpr explicit CCircularBuffer(size_t buffer_size, const Allocator& allocator = Allocator())
+            : allocator_(allocator) {
         size_ = 0;
         begin_ = end_ = 0;
         capacity_ = buffer_size;
-        buffer_ = new T[capacity_ + 1];
+        buffer_ = allocate(capacity_ + 1);
     }
 
-    explicit CCircularBuffer(size_t buffer_size, const T& value) {
+    constexpr explicit CCircularBuffer(size_t buffer_size, const T& value, const Allocator& allocator = Allocator())
+            : allocator_(allocator) {
         size_ = buffer_size;
         begin_ = 0;
         end_ = buffer_size;
         capacity_ = buffer_size;
-        buffer_ = new T[capacity_ + 1];
+        buffer_ = allocate(capacity_ + 1);
 
         for (size_t i = 0; i < buffer_size; i++) {
             buffer_[i] = value;
         }
     }
 
-    ~CCircularBuffer() {
-        delete[] buffer_;
+    constexpr ~CCircularBuffer() {
+        deallocate(buffer_, capacity_ + 1);
         buffer_ = nullptr;
     }
 
-    CCircularBuffer(const CCircularBuffer& other) {
+    constexpr CCircularBuffer(const CCircularBuffer& other)
+            : allocator_(AllocatorTraits::select_on_container_copy_construction(other.allocator_)) {
         size_ = other.size_;
         begin_ = other.begin_;
         end_ = other.end_;
         capacity_ = other.capacity_;
-        buffer_ = new T[capacity_ + 1];
+        buffer_ = allocate(capacity_ + 1);
 
         for (size_t i = 0; i <= capacity_; i++) {
             buffer_[i] = other.buffer_[i];
         }
     }
 
-    CCircularBuffer& operator= (const CCircularBuffer& other) {
+    constexpr CCircularBuffer& operator= (const CCircularBuffer& other) {
         if (*this != other) {
             size_ = other.size_;
             begin_ = other.begin_;
             end_ = other.end_;
+            deallocate(buffer_, capacity_ + 1);
             capacity_ = other.capacity_;
-            delete[] buffer_;
-            buffer_ = new T[capacity_ + 1];
+
+            if constexpr (AllocatorTraits::propagate_on_container_copy_assignment::value) {
+                allocator_ = other.allocator_;
+            }
+
+            buffer_ = allocate(capacity_ + 1);
 
             for (size_t i = 0; i <= capacity_; i++) {
                 buffer_[i] = other.buffer_[i];
@@ -165,19 +256,23 @@ public:
         return *this;
     }
 
-    bool operator== (const CCircularBuffer& rhs) {
+    constexpr bool operator== (const CCircularBuffer& rhs) {
         return std::equal(this->begin(), this->end(), rhs.begin(), rhs.end());
     }
 
-    bool operator!= (const CCircularBuffer& rhs) {
+    constexpr bool operator!= (const CCircularBuffer& rhs) {
         return !std::equal(this->begin(), this->end(), rhs.begin(), rhs.end());
     }
 
-    T& operator[] (size_t num) {
+    constexpr T& operator[] (size_t num) {
         return buffer_[(begin_ + num) % (capacity_ + 1)];
     }
 
-    virtual Iterator insert(Iterator& pointer, const T& value) {
+    constexpr const T& operator[] (size_t num) const {
+        return buffer_[(begin_ + num) % (capacity_ + 1)];
+    }
+
+    virtual constexpr Iterator insert(Iterator& pointer, const T& value) {
         if (pointer == begin()) {
             push_front(value);
             return begin();
@@ -213,7 +308,7 @@ public:
         return pointer;
     }
 
-    Iterator erase(Iterator& pointer) {
+    constexpr Iterator erase(Iterator& pointer) {
         Iterator begin = pointer;
         Iterator end = Iterator(buffer_, capacity_, size_, begin_);
 
@@ -232,7 +327,7 @@ public:
         return pointer;
     }
 
-    Iterator erase(Iterator& begin, Iterator& end) {
+    constexpr Iterator erase(Iterator& begin, Iterator& end) {
         if (empty() || begin >= end) {
             return end;
         }
@@ -258,15 +353,15 @@ public:
         return temp;
     }
 
-    void clear() {
-        delete[] buffer_;
+    constexpr void clear() {
+        deallocate(buffer_, capacity_ + 1);
         buffer_ = nullptr;
         size_ = 0;
         begin_ = 0;
         end_ = 0;
     }
 
-    virtual void push_back(const T& value) {
+    virtual constexpr void push_back(const T& value) {
         buffer_[end_] = value;
         if (end_ == capacity_) {
             end_ = 0;
@@ -283,7 +378,7 @@ public:
         }
     }
 
-    void pop_back() {
+    constexpr void pop_back() {
         if (!empty()) {
             size_--;
             if (end_ == 0) {
@@ -294,25 +389,25 @@ public:
         }
     }
 
-    virtual void push_front(const T& value) {
+    virtual constexpr void push_front(const T& value) {
         if (begin_ == 0) {
             begin_ = capacity_;
-            end_--;
-        } else if (end_ == 0) {
-            begin_--;
-            end_ = capacity_;
         } else {
             begin_--;
-            end_--;
         }
 
-        if (size_ != capacity_)
+        if (size_ != capacity_) {
             size_++;
+        } else if (end_ == 0) {
+            end_ = capacity_;
+        } else {
+            end_--;
+        }
 
         buffer_[begin_] = value;
     }
 
-    void pop_front() {
+    constexpr void pop_front() {
         if (!empty()) {
             size_--;
             if (begin_ == capacity_) {
@@ -323,48 +418,130 @@ public:
         }
     }
 
-    [[nodiscard]] Iterator begin() const {
+    // Moves the elements inside the existing storage so that they start at
+    // slot 0 and returns them as one contiguous span, e.g. for sorting or a
+    // C API taking T*. Iterators obtained before are invalidated.
+    constexpr std::span<T> linearize() {
+        if (empty()) {
+            begin_ = end_ = 0;
+            return {};
+        }
+
+        if (begin_ != 0) {
+            if (begin_ + size_ <= capacity_ + 1) {
+                std::move(buffer_ + begin_, buffer_ + begin_ + size_, buffer_);
+            } else if constexpr (std::is_trivially_copyable_v<T>) {
+                blockSwapRotate(buffer_, buffer_ + begin_, buffer_ + capacity_ + 1);
+            } else {
+                std::rotate(buffer_, buffer_ + begin_, buffer_ + capacity_ + 1);
+            }
+
+            begin_ = 0;
+            end_ = size_ % (capacity_ + 1);
+        }
+
+        return std::span<T>(buffer_, size_);
+    }
+
+    [[nodiscard]] constexpr bool is_linearized() const {
+        return begin_ == 0 || empty();
+    }
+
+    // Passes up to max front elements to callback in order, then removes them
+    // with a single begin_ update. Walks the at most two physical segments
+    // directly instead of going through Iterator, prefetching the slot
+    // 2 * distance elements ahead and, if projection is given, the address it
+    // returns for the element distance ahead (whose slot is in cache by
+    // then), e.g. the node behind a pointer. Both are issued up front for
+    // the start of the batch. A distance of 0 disables prefetching. Returns
+    // the number consumed.
+    template <typename Callback, typename Projection = NoProjection>
+    constexpr size_t consume_batch(size_t max, Callback callback, size_t distance = kPrefetchDistance,
+                                   Projection projection = Projection()) {
+        size_t count = std::min(max, size_);
+        size_t first = std::min(count, capacity_ + 1 - begin_);
+        auto slot = [&](size_t index) {
+            return index < first ? buffer_ + begin_ + index : buffer_ + (index - first);
+        };
+
+        for (size_t i = 0; i < std::min(count, 2 * distance); i++) {
+            prefetch(slot(i));
+        }
+
+        if constexpr (!std::is_same_v<Projection, NoProjection>) {
+            for (size_t i = 0; i < std::min(count, distance); i++) {
+                prefetch(projection(*slot(i)));
+            }
+        }
+
+        T* segments[2] = {buffer_ + begin_, buffer_};
+        size_t lengths[2] = {first, count - first};
+        size_t index = 0;
+
+        for (size_t segment = 0; segment < 2; segment++) {
+            for (T* element = segments[segment]; element != segments[segment] + lengths[segment]; element++, index++) {
+                if (distance != 0 && index + 2 * distance < count) {
+                    prefetch(slot(index + 2 * distance));
+                }
+
+                if constexpr (!std::is_same_v<Projection, NoProjection>) {
+                    if (distance != 0 && index + distance < count) {
+                        prefetch(projection(*slot(index + distance)));
+                    }
+                }
+
+                callback(*element);
+            }
+        }
+
+        begin_ = (begin_ + count) % (capacity_ + 1);
+        size_ -= count;
+
+        return count;
+    }
+
+    [[nodiscard]] constexpr Iterator begin() const {
         return Iterator(buffer_, capacity_, 0, begin_);
     }
 
-    Iterator begin() {
+    constexpr Iterator begin() {
         return Iterator(buffer_, capacity_, 0, begin_);
     }
 
-    Iterator cbegin() {
+    constexpr Iterator cbegin() {
         return const_cast<const CCircularBuffer*>(this)->begin();
     }
 
-    [[nodiscard]] Iterator end() const {
+    [[nodiscard]] constexpr Iterator end() const {
         return Iterator(buffer_, capacity_, size_, begin_);
     }
 
-    Iterator end() {
+    constexpr Iterator end() {
         return Iterator(buffer_, capacity_, size_, begin_);
     }
 
-    Iterator cend() {
+    constexpr Iterator cend() {
         return const_cast<const CCircularBuffer*>(this)->end();
     }
 
-    inline bool empty() {
+    constexpr bool empty() const {
         return size_ == 0;
     }
 
-    inline size_t size() {
+    constexpr size_t size() const {
         return size_;
     }
 
-    inline size_t max_size() {
+    constexpr size_t max_size() const {
         return capacity_;
     }
 
-    inline T front() {
+    constexpr T front() {
         return buffer_[begin_];
     }
 
-    T back() {
-        return buffer_[end_ - 1];
+    constexpr T back() {
+        return buffer_[(end_ + capacity_) % (capacity_ + 1)];
     }
 };
 
@@ -2,27 +2,30 @@
 
 #include "CCircularBuffer.h"
 
-template <typename T>
-class CCircularBufferExp final : public CCircularBuffer<T> {
-    using CCircularBuffer<T>::buffer_;
-    using CCircularBuffer<T>::size_;
-    using CCircularBuffer<T>::begin_;
-    using CCircularBuffer<T>::end_;
-    using CCircularBuffer<T>::capacity_;
+template <typename T, typename Allocator = std::allocator<T>>
+class CCircularBufferExp final : public CCircularBuffer<T, Allocator> {
+    using CCircularBuffer<T, Allocator>::buffer_;
+    using CCircularBuffer<T, Allocator>::size_;
+    using CCircularBuffer<T, Allocator>::begin_;
+    using CCircularBuffer<T, Allocator>::end_;
+    using CCircularBuffer<T, Allocator>::capacity_;
 public:
-    using Iterator = CCircularBuffer<T>::Iterator;
+    using Iterator = CCircularBuffer<T, Allocator>::Iterator;
 
-    CCircularBufferExp() : CCircularBuffer<T>() {};
-    explicit CCircularBufferExp(size_t buffer_size) : CCircularBuffer<T>(buffer_size) {};
-    explicit CCircularBufferExp(size_t buffer_size, const T& value) : CCircularBuffer<T>(buffer_size, value) {};
+    constexpr explicit CCircularBufferExp(const Allocator& allocator = Allocator())
+            : CCircularBuffer<T, Allocator>(allocator) {};
+    constexpr explicit CCircularBufferExp(size_t buffer_size, const Allocator& allocator = Allocator())
+            : CCircularBuffer<T, Allocator>(buffer_size, allocator) {};
+    constexpr explicit CCircularBufferExp(size_t buffer_size, const T& value, const Allocator& allocator = Allocator())
+            : CCircularBuffer<T, Allocator>(buffer_size, value, allocator) {};
 
-    Iterator insert(Iterator& pointer, const T& value) override {
+    constexpr Iterator insert(Iterator& pointer, const T& value) override {
         if (size_ != capacity_) {
-             return CCircularBuffer<T>::insert(pointer, value);
+             return CCircularBuffer<T, Allocator>::insert(pointer, value);
         } else {
-            T* new_buffer = new T[capacity_* 2 + 1];
+            T* new_buffer = CCircularBuffer<T, Allocator>::allocate(capacity_* 2 + 1);
             size_t it = 0;
-            auto begin_it = CCircularBuffer<T>::begin();
+            auto begin_it = CCircularBuffer<T, Allocator>::begin();
 
             while (begin_it != pointer) {
                 new_buffer[it] = *begin_it;
@@ -37,7 +40,7 @@ public:
                 new_buffer[i + 1] = buffer_[(begin_ + i) % (capacity_ + 1)];
             }
 
-            delete[] buffer_;
+            CCircularBuffer<T, Allocator>::deallocate(buffer_, capacity_ + 1);
             buffer_ = new_buffer;
             size_++;
             begin_ = 0;
@@ -48,18 +51,18 @@ public:
         }
     }
 
-    void push_back(const T& value) override {
+    constexpr void push_back(const T& value) override {
         if (size_ != capacity_) {
-            CCircularBuffer<T>::push_back(value);
+            CCircularBuffer<T, Allocator>::push_back(value);
         } else {
-            T* new_buffer = new T[capacity_* 2 + 1];
+            T* new_buffer = CCircularBuffer<T, Allocator>::allocate(capacity_* 2 + 1);
             new_buffer[capacity_] = value;
 
             for (size_t i = 0; i < capacity_; i++) {
                 new_buffer[i] = buffer_[(begin_ + i) % (capacity_ + 1)];
             }
 
-            delete[] buffer_;
+            CCircularBuffer<T, Allocator>::deallocate(buffer_, capacity_ + 1);
             buffer_ = new_buffer;
             size_++;
             begin_ = 0;
@@ -68,18 +71,18 @@ public:
         }
     }
 
-    void push_front(const T& value) override {
+    constexpr void push_front(const T& value) override {
         if (size_ != capacity_) {
-            CCircularBuffer<T>::push_front(value);
+            CCircularBuffer<T, Allocator>::push_front(value);
         } else {
-            T* new_buffer = new T[capacity_* 2 + 1];
+            T* new_buffer = CCircularBuffer<T, Allocator>::allocate(capacity_* 2 + 1);
             new_buffer[0] = value;
 
             for (size_t i = 0; i < capacity_; i++) {
                 new_buffer[i + 1] = buffer_[(begin_ + i) % (capacity_ + 1)];
             }
 
-            delete[] buffer_;
+            CCircularBuffer<T, Allocator>::deallocate(buffer_, capacity_ + 1);
             buffer_ = new_buffer;
             size_++;
             begin_ = 0;
@@ -0,0 +1,289 @@
+#pragma once
+
+#include "CCircularBuffer.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+
+// History ring of integers stored as blocks of BlockSize delta + zigzag +
+// varint encoded values in a fixed byte budget. Slowly changing series such
+// as counters and timestamps take one or two bytes per value instead of
+// sizeof(T). When the budget is exhausted whole blocks are dropped from the
+// front. Values are appended to an open block which is sealed into the byte
+// ring once full; iteration decodes blocks lazily. The block index adds a
+// Block descriptor per BlockSize budget bytes on top, reported by
+// index_bytes() and included in memory_used().
+template <typename T = int64_t, size_t BlockSize = 128>
+class CCompressedHistory {
+    static_assert(std::is_integral_v<T>, "CCompressedHistory stores integers only");
+    static_assert(BlockSize != 0, "BlockSize must be positive");
+
+    using Unsigned = std::make_unsigned_t<T>;
+    using Signed = std::make_signed_t<T>;
+
+    static constexpr size_t kMaxVarint = (std::numeric_limits<Unsigned>::digits + 6) / 7;
+    static constexpr size_t kMaxBlockBytes = BlockSize * kMaxVarint;
+
+    // A sealed block occupies bytes [offset, offset + length) of bytes_. The
+    // first value is encoded as a delta from zero, so every block decodes on
+    // its own.
+    struct Block {
+        size_t offset;
+        size_t length;
+        size_t count;
+    };
+
+    uint8_t* bytes_;
+    size_t byte_capacity_;
+    size_t tail_;
+    CCircularBuffer<Block> blocks_;
+
+    uint8_t open_bytes_[kMaxBlockBytes];
+    size_t open_length_;
+    size_t open_count_;
+    T last_;
+
+    size_t size_;
+
+    static size_t encode(uint8_t* out, T value, T previous) {
+        Unsigned delta = static_cast<Unsigned>(value) - static_cast<Unsigned>(previous);
+        Unsigned zigzag = (delta << 1) ^ static_cast<Unsigned>(static_cast<Signed>(delta) >> (std::numeric_limits<Unsigned>::digits - 1));
+        size_t length = 0;
+
+        while (zigzag >= 0x80) {
+            out[length++] = static_cast<uint8_t>(zigzag | 0x80);
+            zigzag >>= 7;
+        }
+        out[length++] = static_cast<uint8_t>(zigzag);
+
+        return length;
+    }
+
+    static const uint8_t* decode(const uint8_t* in, T previous, T& value) {
+        Unsigned zigzag = 0;
+        int shift = 0;
+
+        while (*in & 0x80) {
+            zigzag |= static_cast<Unsigned>(*in++ & 0x7f) << shift;
+            shift += 7;
+        }
+        zigzag |= static_cast<Unsigned>(*in++) << shift;
+
+        Unsigned delta = (zigzag >> 1) ^ (Unsigned(0) - (zigzag & 1));
+        value = static_cast<T>(static_cast<Unsigned>(previous) + delta);
+
+        return in;
+    }
+
+    void evictFrontBlock() {
+        size_ -= blocks_[0].count;
+        blocks_.pop_front();
+    }
+
+    // Offset where length bytes fit contiguously, evicting front blocks
+    // until they do.
+    size_t reserve(size_t length) {
+        while (!blocks_.empty()) {
+            size_t head = blocks_[0].offset;
+
+            if (tail_ > head) {
+                if (tail_ + length <= byte_capacity_) {
+                    return tail_;
+                }
+                if (length <= head) {
+                    return 0;
+                }
+            } else if (tail_ + length <= head) {
+                return tail_;
+            }
+
+            evictFrontBlock();
+        }
+
+        return 0;
+    }
+
+    void seal() {
+        if (open_count_ == 0) {
+            return;
+        }
+
+        if (blocks_.size() == blocks_.max_size()) {
+            evictFrontBlock();
+        }
+
+        size_t offset = reserve(open_length_);
+        std::copy(open_bytes_, open_bytes_ + open_length_, bytes_ + offset);
+        blocks_.push_back({offset, open_length_, open_count_});
+        tail_ = offset + open_length_;
+
+        open_length_ = 0;
+        open_count_ = 0;
+    }
+
+public:
+    class Iterator {
+        const CCompressedHistory* history_;
+        size_t block_;
+        size_t remaining_;
+        size_t index_;
+        const uint8_t* next_;
+        T value_;
+
+        void enterBlock() {
+            if (block_ < history_->blocks_.size()) {
+                Block block = history_->blocks_[block_];
+                next_ = history_->bytes_ + block.offset;
+                remaining_ = block.count;
+            } else {
+                next_ = history_->open_bytes_;
+                remaining_ = history_->open_count_;
+            }
+
+            if (remaining_ != 0) {
+                next_ = decode(next_, 0, value_);
+            }
+        }
+
+    public:
+        // Values are decoded into the iterator and returned by value, so it
+        // is only a legacy input iterator, though a C++20 forward iterator.
+        using iterator_concept = std::forward_iterator_tag;
+        using iterator_category = std::input_iterator_tag;
+        using difference_type = std::ptrdiff_t;
+        using value_type = T;
+        using pointer = void;
+        using reference = T;
+
+        Iterator() : history_(nullptr), block_(0), remaining_(0), index_(0), next_(nullptr), value_(0) {};
+        Iterator(const CCompressedHistory* history, size_t index)
+                : history_(history), block_(0), remaining_(0), index_(index), next_(nullptr), value_(0) {
+            if (index_ != history_->size_) {
+                enterBlock();
+            }
+        }
+
+        reference operator*() const {
+            return value_;
+        }
+
+        Iterator& operator++() {
+            index_++;
+            remaining_--;
+
+            if (remaining_ != 0) {
+                next_ = decode(next_, value_, value_);
+            } else if (index_ != history_->size_) {
+                block_++;
+                enterBlock();
+            }
+
+            return *this;
+        }
+
+        Iterator operator++(int) {
+            Iterator iterator = *this;
+            ++*this;
+            return iterator;
+        }
+
+        bool operator== (const Iterator& other) const {
+            return index_ == other.index_;
+        }
+    };
+
+    explicit CCompressedHistory(size_t byte_capacity)
+            : tail_(0), blocks_(byte_capacity / BlockSize + 1), open_length_(0), open_count_(0), last_(0), size_(0) {
+        if (byte_capacity < kMaxBlockBytes) {
+            throw std::invalid_argument("CCompressedHistory byte capacity is smaller than one block");
+        }
+
+        bytes_ = new uint8_t[byte_capacity];
+        byte_capacity_ = byte_capacity;
+    }
+
+    ~CCompressedHistory() {
+        delete[] bytes_;
+    }
+
+    CCompressedHistory(const CCompressedHistory& other) = delete;
+    CCompressedHistory& operator= (const CCompressedHistory& other) = delete;
+
+    void push_back(T value) {
+        open_length_ += encode(open_bytes_ + open_length_, value, open_count_ == 0 ? 0 : last_);
+        open_count_++;
+        size_++;
+        last_ = value;
+
+        if (open_count_ == BlockSize) {
+            seal();
+        }
+    }
+
+    void clear() {
+        while (!blocks_.empty()) {
+            blocks_.pop_front();
+        }
+
+        tail_ = 0;
+        open_length_ = 0;
+        open_count_ = 0;
+        size_ = 0;
+    }
+
+    [[nodiscard]] Iterator begin() const {
+        return Iterator(this, 0);
+    }
+
+    [[nodiscard]] Iterator end() const {
+        return Iterator(this, size_);
+    }
+
+    [[nodiscard]] bool empty() const {
+        return size_ == 0;
+    }
+
+    [[nodiscard]] size_t size() const {
+        return size_;
+    }
+
+    [[nodiscard]] T back() const {
+        return last_;
+    }
+
+    [[nodiscard]] size_t block_count() const {
+        return blocks_.size() + (open_count_ != 0 ? 1 : 0);
+    }
+
+    [[nodiscard]] size_t byte_capacity() const {
+        return byte_capacity_;
+    }
+
+    // Encoded bytes currently held. Includes the open block, which is kept
+    // outside the byte budget until it is sealed.
+    [[nodiscard]] size_t bytes_used() const {
+        size_t result = open_length_;
+
+        for (size_t i = 0; i < blocks_.size(); i++) {
+            result += blocks_[i].length;
+        }
+
+        return result;
+    }
+
+    // Memory of the block index: one Block descriptor per slot, allocated up
+    // front for the largest number of blocks the byte budget can hold.
+    [[nodiscard]] size_t index_bytes() const {
+        return (blocks_.max_size() + 1) * sizeof(Block);
+    }
+
+    // All memory the history allocates: the byte ring, the open block and
+    // the block index.
+    [[nodiscard]] size_t memory_used() const {
+        return byte_capacity_ + sizeof(open_bytes_) + index_bytes();
+    }
+};
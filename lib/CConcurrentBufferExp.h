@@ -0,0 +1,359 @@
+#pragma once
+
+#include "CCircularBufferExp.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <iterator>
+#include <stdexcept>
+
+// Growable circular buffer for one writer and concurrent readers. Like
+// CCircularBufferExp it doubles its capacity when full, but growth never
+// stops readers: the new array is published atomically, readers that are
+// still on the old one finish there, and the old array is freed by
+// epoch-based reclamation once no reader can reach it.
+//
+// Elements are addressed by 64-bit sequences that never wrap: push_back
+// appends sequence tail, pop_front drops sequence head, and sequence s lives
+// in slot s % capacity of whichever array a reader sees. The writer never
+// reuses a popped slot until every reader that could still see it has left,
+// so readers never race with writes.
+// A reader that stays inside one guard holds back reuse of everything
+// popped since it entered, so capacity grows with how far the writer gets
+// meanwhile; taking a new guard releases it.
+//
+// Readers are numbered 0 .. reader_count - 1, each used by one thread at a
+// time, and read through a ReadGuard. A reader must not hold two ReadGuards
+// at once: the inner one would mark the reader inactive on destruction while
+// the outer one is still reading.
+template <typename T>
+class CConcurrentBufferExp {
+    struct Storage {
+        T* buffer;
+        size_t capacity;
+
+        explicit Storage(size_t buffer_size) : buffer(new T[buffer_size]), capacity(buffer_size) {};
+
+        Storage(const Storage& other) = delete;
+        Storage& operator= (const Storage& other) = delete;
+
+        ~Storage() {
+            delete[] buffer;
+        }
+    };
+
+    struct Retired {
+        Storage* storage;
+        uint64_t epoch;
+        Retired* next;
+    };
+
+    // Slots below head are free for reuse once every active reader entered
+    // at epoch or later.
+    struct Mark {
+        uint64_t epoch;
+        uint64_t head;
+    };
+
+    // Epoch a reader entered with, 0 while it is outside a ReadGuard.
+    struct alignas(64) ReaderSlot {
+        std::atomic<uint64_t> epoch = 0;
+    };
+
+    alignas(64) std::atomic<Storage*> storage_;
+    std::atomic<uint64_t> head_;
+    std::atomic<uint64_t> tail_;
+    std::atomic<uint64_t> epoch_;
+
+    ReaderSlot* readers_;
+    size_t reader_count_;
+
+    // Writer only: slots from safe_head_ on may still be read, and the
+    // marks not yet passed by every reader, oldest first.
+    uint64_t safe_head_;
+    CCircularBufferExp<Mark> marks_;
+    Retired* retired_;
+
+    // Smallest epoch of an active reader, UINT64_MAX if there is none.
+    [[nodiscard]] uint64_t oldestReader() const {
+        uint64_t result = UINT64_MAX;
+
+        for (size_t i = 0; i < reader_count_; i++) {
+            uint64_t epoch = readers_[i].epoch.load();
+
+            if (epoch != 0) {
+                result = std::min(result, epoch);
+            }
+        }
+
+        return result;
+    }
+
+    // Records the current head under a new epoch if there were pops since the
+    // last mark, then frees what no active reader can reach any more: retired
+    // arrays, and slots below the newest mark every reader has passed. Since
+    // marks are per pass rather than all-or-nothing against the latest pop,
+    // a reader that keeps taking new guards does not stop slot reuse.
+    void reclaim() {
+        uint64_t head = head_.load(std::memory_order_relaxed);
+
+        if (head != (marks_.empty() ? safe_head_ : marks_.back().head)) {
+            marks_.push_back({epoch_.fetch_add(1) + 1, head});
+        }
+
+        uint64_t oldest = oldestReader();
+        Retired** link = &retired_;
+
+        while (*link != nullptr) {
+            Retired* retired = *link;
+
+            if (retired->epoch <= oldest) {
+                *link = retired->next;
+                delete retired->storage;
+                delete retired;
+            } else {
+                link = &retired->next;
+            }
+        }
+
+        while (!marks_.empty() && marks_[0].epoch <= oldest) {
+            safe_head_ = marks_[0].head;
+            marks_.pop_front();
+        }
+    }
+
+    void grow() {
+        Storage* old_storage = storage_.load(std::memory_order_relaxed);
+        auto* new_storage = new Storage(old_storage->capacity * 2);
+        uint64_t tail = tail_.load(std::memory_order_relaxed);
+
+        // Popped elements a reader may still see are carried over too: such a
+        // reader can pair its older head with the new array.
+        for (uint64_t sequence = safe_head_; sequence != tail; sequence++) {
+            new_storage->buffer[sequence % new_storage->capacity] = old_storage->buffer[sequence % old_storage->capacity];
+        }
+
+        storage_.store(new_storage);
+        retired_ = new Retired{old_storage, epoch_.fetch_add(1) + 1, retired_};
+    }
+
+public:
+    // Consistent view of the elements at the moment the guard was taken.
+    // Holds off reclamation of the array it reads while it is alive.
+    class ReadGuard {
+        ReaderSlot* slot_;
+        Storage* storage_;
+        uint64_t head_;
+        uint64_t tail_;
+
+    public:
+        class Iterator {
+            const Storage* storage_;
+            uint64_t sequence_;
+
+        public:
+            using iterator_category = std::random_access_iterator_tag;
+            using difference_type = std::ptrdiff_t;
+            using value_type = T;
+            using pointer = const T*;
+            using reference = const T&;
+
+            Iterator() : storage_(nullptr), sequence_(0) {};
+            Iterator(const Storage* storage, uint64_t sequence) : storage_(storage), sequence_(sequence) {};
+
+            reference operator*() const {
+                return storage_->buffer[sequence_ % storage_->capacity];
+            }
+
+            pointer operator->() const {
+                return &**this;
+            }
+
+            reference operator[](difference_type num) const {
+                return *(*this + num);
+            }
+
+            Iterator& operator++() {
+                sequence_++;
+                return *this;
+            }
+
+            Iterator operator++(int) {
+                Iterator iterator = *this;
+                sequence_++;
+                return iterator;
+            }
+
+            Iterator& operator--() {
+                sequence_--;
+                return *this;
+            }
+
+            Iterator operator--(int) {
+                Iterator iterator = *this;
+                sequence_--;
+                return iterator;
+            }
+
+            Iterator& operator+= (difference_type num) {
+                sequence_ += num;
+                return *this;
+            }
+
+            Iterator& operator-= (difference_type num) {
+                sequence_ -= num;
+                return *this;
+            }
+
+            Iterator operator+ (difference_type num) const {
+                Iterator iterator = *this;
+                iterator += num;
+                return iterator;
+            }
+
+            friend Iterator operator+ (difference_type num, const Iterator& iterator) {
+                return iterator + num;
+            }
+
+            Iterator operator- (difference_type num) const {
+                Iterator iterator = *this;
+                iterator -= num;
+                return iterator;
+            }
+
+            difference_type operator- (const Iterator& other) const {
+                return static_cast<difference_type>(sequence_ - other.sequence_);
+            }
+
+            bool operator== (const Iterator& other) const {
+                return sequence_ == other.sequence_;
+            }
+
+            auto operator<=> (const Iterator& other) const {
+                return sequence_ <=> other.sequence_;
+            }
+        };
+
+        // Entering publishes the epoch before reading any position, so the
+        // writer either sees this reader or this reader sees its updates.
+        ReadGuard(CConcurrentBufferExp& buffer, size_t reader) {
+            if (reader >= buffer.reader_count_) {
+                throw std::out_of_range("In CConcurrentBufferExp reader is out of range");
+            }
+
+            slot_ = buffer.readers_ + reader;
+            slot_->epoch.store(buffer.epoch_.load());
+
+            head_ = buffer.head_.load();
+            tail_ = buffer.tail_.load();
+            storage_ = buffer.storage_.load();
+        }
+
+        ~ReadGuard() {
+            slot_->epoch.store(0, std::memory_order_release);
+        }
+
+        ReadGuard(const ReadGuard& other) = delete;
+        ReadGuard& operator= (const ReadGuard& other) = delete;
+
+        const T& operator[] (size_t num) const {
+            return storage_->buffer[(head_ + num) % storage_->capacity];
+        }
+
+        [[nodiscard]] Iterator begin() const {
+            return Iterator(storage_, head_);
+        }
+
+        [[nodiscard]] Iterator end() const {
+            return Iterator(storage_, tail_);
+        }
+
+        [[nodiscard]] bool empty() const {
+            return head_ == tail_;
+        }
+
+        [[nodiscard]] size_t size() const {
+            return tail_ - head_;
+        }
+    };
+
+    CConcurrentBufferExp(size_t buffer_size, size_t reader_count)
+            : storage_(new Storage(std::max<size_t>(buffer_size, 1))), head_(0), tail_(0), epoch_(1),
+              readers_(new ReaderSlot[reader_count]), reader_count_(reader_count),
+              safe_head_(0), marks_(4), retired_(nullptr) {};
+
+    ~CConcurrentBufferExp() {
+        while (retired_ != nullptr) {
+            Retired* next = retired_->next;
+            delete retired_->storage;
+            delete retired_;
+            retired_ = next;
+        }
+
+        delete storage_.load();
+        delete[] readers_;
+    }
+
+    CConcurrentBufferExp(const CConcurrentBufferExp& other) = delete;
+    CConcurrentBufferExp& operator= (const CConcurrentBufferExp& other) = delete;
+
+    [[nodiscard]] ReadGuard read(size_t reader) {
+        return ReadGuard(*this, reader);
+    }
+
+    // Writer only. Doubles the capacity when every slot holds an element or
+    // a popped element some reader may still be looking at.
+    void push_back(const T& value) {
+        Storage* storage = storage_.load(std::memory_order_relaxed);
+        uint64_t tail = tail_.load(std::memory_order_relaxed);
+
+        if (tail - safe_head_ == storage->capacity) {
+            reclaim();
+
+            if (tail - safe_head_ == storage->capacity) {
+                grow();
+                storage = storage_.load(std::memory_order_relaxed);
+            }
+        }
+
+        storage->buffer[tail % storage->capacity] = value;
+        tail_.store(tail + 1);
+    }
+
+    // Writer only.
+    void pop_front() {
+        uint64_t head = head_.load(std::memory_order_relaxed);
+
+        if (head != tail_.load(std::memory_order_relaxed)) {
+            head_.store(head + 1);
+        }
+    }
+
+    // Writer only; frees retired arrays no reader can reach any more.
+    void collect() {
+        reclaim();
+    }
+
+    [[nodiscard]] bool empty() const {
+        return size() == 0;
+    }
+
+    [[nodiscard]] size_t size() const {
+        return tail_.load() - head_.load();
+    }
+
+    [[nodiscard]] size_t max_size() const {
+        return storage_.load()->capacity;
+    }
+
+    [[nodiscard]] size_t retired_count() const {
+        size_t result = 0;
+
+        for (Retired* retired = retired_; retired != nullptr; retired = retired->next) {
+            result++;
+        }
+
+        return result;
+    }
+};
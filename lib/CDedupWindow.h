@@ -0,0 +1,150 @@
+#pragma once
+
+#include "CCircularBuffer.h"
+
+#include <cstdint>
+#include <functional>
+#include <stdexcept>
+
+// Deduplication window over the last window_size distinct keys: a
+// CCircularBuffer holding them in arrival order, paired with an
+// open-addressing hash index kept in sync on every insert and eviction.
+// contains and insert_if_absent are O(1) on average. Everything is allocated
+// at construction, nothing on the hot path.
+//
+// The index uses linear probing at a load factor of at most 1/2 and
+// backward-shift deletion, so evictions leave no tombstones behind and
+// probe lengths stay short however long the window runs.
+template <typename Key = uint64_t, typename Hash = std::hash<Key>>
+class CDedupWindow {
+    CCircularBuffer<Key> window_;
+    Key* keys_;
+    bool* used_;
+    size_t mask_;
+    Hash hash_;
+
+    // Home slot of key. The hash is run through a 64-bit finalizer since
+    // std::hash of integers is usually the identity, which clusters badly
+    // under linear probing with power-of-two tables.
+    [[nodiscard]] size_t home(const Key& key) const {
+        uint64_t hash = static_cast<uint64_t>(hash_(key));
+
+        hash ^= hash >> 33;
+        hash *= 0xff51afd7ed558ccdULL;
+        hash ^= hash >> 33;
+        hash *= 0xc4ceb9fe1a85ec53ULL;
+        hash ^= hash >> 33;
+
+        return static_cast<size_t>(hash) & mask_;
+    }
+
+    // Slot holding key, or the empty slot where it would go.
+    [[nodiscard]] size_t find(const Key& key) const {
+        size_t slot = home(key);
+
+        while (used_[slot] && !(keys_[slot] == key)) {
+            slot = (slot + 1) & mask_;
+        }
+
+        return slot;
+    }
+
+    void erase(const Key& key) {
+        size_t hole = find(key);
+
+        if (!used_[hole]) {
+            return;
+        }
+
+        used_[hole] = false;
+
+        // Pull following entries of the probe run back into the hole unless
+        // their home slot lies cyclically in (hole, slot].
+        for (size_t slot = (hole + 1) & mask_; used_[slot]; slot = (slot + 1) & mask_) {
+            size_t target = home(keys_[slot]);
+
+            if (((slot - target) & mask_) >= ((slot - hole) & mask_)) {
+                keys_[hole] = keys_[slot];
+                used_[hole] = true;
+                used_[slot] = false;
+                hole = slot;
+            }
+        }
+    }
+
+public:
+    explicit CDedupWindow(size_t window_size, const Hash& hash = Hash())
+            : window_(window_size), hash_(hash) {
+        if (window_size == 0) {
+            throw std::invalid_argument("CDedupWindow size must be positive");
+        }
+
+        size_t table_size = 2;
+        while (table_size < window_size * 2) {
+            table_size *= 2;
+        }
+
+        keys_ = new Key[table_size];
+        used_ = new bool[table_size]();
+        mask_ = table_size - 1;
+    }
+
+    ~CDedupWindow() {
+        delete[] keys_;
+        delete[] used_;
+    }
+
+    CDedupWindow(const CDedupWindow& other) = delete;
+    CDedupWindow& operator= (const CDedupWindow& other) = delete;
+
+    [[nodiscard]] bool contains(const Key& key) const {
+        return used_[find(key)];
+    }
+
+    // Adds key as the newest entry unless it is already in the window,
+    // evicting the oldest entry when the window is full. Returns whether key
+    // was added, i.e. is not a duplicate.
+    bool insert_if_absent(const Key& key) {
+        size_t slot = find(key);
+
+        if (used_[slot]) {
+            return false;
+        }
+
+        if (window_.size() == window_.max_size()) {
+            erase(window_[0]);
+            window_.pop_front();
+            slot = find(key);
+        }
+
+        keys_[slot] = key;
+        used_[slot] = true;
+        window_.push_back(key);
+
+        return true;
+    }
+
+    void clear() {
+        while (!window_.empty()) {
+            erase(window_[0]);
+            window_.pop_front();
+        }
+    }
+
+    [[nodiscard]] bool empty() const {
+        return window_.empty();
+    }
+
+    [[nodiscard]] size_t size() const {
+        return window_.size();
+    }
+
+    [[nodiscard]] size_t max_size() const {
+        return window_.max_size();
+    }
+
+    // Oldest key, the next to be evicted.
+    [[nodiscard]] const Key& front() const {
+        return window_[0];
+    }
+};
@@ -0,0 +1,187 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <system_error>
+#include <thread>
+
+#ifdef __linux__
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+// Allocation settings for CHugePageAllocator.
+struct CHugePagePolicy {
+    // Try explicit huge pages (MAP_HUGETLB) before transparent ones. Needs
+    // pages reserved in /proc/sys/vm/nr_hugepages, otherwise falls back.
+    bool explicit_huge_pages = false;
+    // NUMA node the pages should preferably come from, -1 for no preference.
+    int preferred_node = -1;
+    // Number of threads touching every page right after allocation, 0 to
+    // leave pages to be faulted in on first write.
+    size_t prefault_threads = 0;
+    // Allocations below this size go to operator new.
+    size_t min_size = kHugePageSize;
+
+    static constexpr size_t kHugePageSize = 2 * 1024 * 1024;
+};
+
+// Allocator for very large CCircularBuffer storage. Memory is mapped
+// directly, backed by huge pages where the system allows it, optionally
+// bound to a NUMA node and pre-faulted in parallel, so that the first pass
+// of sequential writes does not stall on page faults and TLB misses. Every
+// step falls back silently: without huge pages, NUMA or Linux the result is
+// ordinary memory.
+//
+// Usage: CCircularBuffer<T, CHugePageAllocator<T>> buffer(n, CHugePageAllocator<T>(policy));
+template <typename T>
+class CHugePageAllocator {
+    template <typename U>
+    friend class CHugePageAllocator;
+
+    CHugePagePolicy policy_;
+
+    [[nodiscard]] static size_t mappedSize(size_t bytes) {
+        return (bytes + CHugePagePolicy::kHugePageSize - 1) / CHugePagePolicy::kHugePageSize * CHugePagePolicy::kHugePageSize;
+    }
+
+    [[nodiscard]] bool isMapped([[maybe_unused]] size_t bytes) const {
+#ifdef __linux__
+        return bytes >= policy_.min_size;
+#else
+        return false;
+#endif
+    }
+
+#ifdef __linux__
+    static void* map(size_t size, bool explicit_huge_pages) {
+        void* memory = MAP_FAILED;
+
+        if (explicit_huge_pages) {
+            memory = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        }
+
+        if (memory == MAP_FAILED) {
+            memory = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+            if (memory == MAP_FAILED) {
+                throw std::bad_alloc();
+            }
+
+            madvise(memory, size, MADV_HUGEPAGE);
+        }
+
+        return memory;
+    }
+
+    static void bind(void* memory, size_t size, int node) {
+        const int kPreferred = 1;
+        const size_t kMaxNodes = 1024;
+        const size_t kBits = sizeof(unsigned long) * 8;
+
+        if (node < 0 || static_cast<size_t>(node) >= kMaxNodes) {
+            return;
+        }
+
+        unsigned long mask[kMaxNodes / kBits] = {};
+        mask[node / kBits] = 1UL << (node % kBits);
+
+        syscall(SYS_mbind, memory, size, kPreferred, mask, kMaxNodes + 1, 0);
+    }
+
+    static void prefault(void* memory, size_t size, size_t thread_count) {
+        const size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+        size_t pages = size / page;
+        size_t per_thread = (pages + thread_count - 1) / thread_count;
+        auto* bytes = static_cast<volatile char*>(memory);
+
+        auto touch = [bytes, page, pages](size_t first, size_t last) {
+            for (size_t i = first; i < last && i < pages; i++) {
+                bytes[i * page] = 0;
+            }
+        };
+
+        std::unique_ptr<std::thread[]> threads(new std::thread[thread_count - 1]);
+        size_t started = 1;
+
+        // If a thread cannot be created, the calling thread touches the
+        // ranges that are left.
+        try {
+            for (; started < thread_count; started++) {
+                threads[started - 1] = std::thread(touch, started * per_thread, (started + 1) * per_thread);
+            }
+        } catch (const std::system_error&) {
+            touch(started * per_thread, pages);
+        }
+
+        touch(0, per_thread);
+
+        for (size_t i = 1; i < started; i++) {
+            threads[i - 1].join();
+        }
+    }
+#endif
+
+public:
+    using value_type = T;
+
+    CHugePageAllocator() = default;
+    explicit CHugePageAllocator(const CHugePagePolicy& policy) : policy_(policy) {};
+
+    template <typename U>
+    CHugePageAllocator(const CHugePageAllocator<U>& other) : policy_(other.policy_) {};
+
+    [[nodiscard]] const CHugePagePolicy& policy() const {
+        return policy_;
+    }
+
+    T* allocate(size_t count) {
+        size_t bytes = count * sizeof(T);
+
+        if (!isMapped(bytes)) {
+            return static_cast<T*>(::operator new(bytes, std::align_val_t(alignof(T))));
+        }
+
+#ifdef __linux__
+        size_t size = mappedSize(bytes);
+        void* memory = map(size, policy_.explicit_huge_pages);
+
+        bind(memory, size, policy_.preferred_node);
+
+        if (policy_.prefault_threads != 0) {
+            try {
+                prefault(memory, size, policy_.prefault_threads);
+            } catch (...) {
+                munmap(memory, size);
+                throw;
+            }
+        }
+
+        return static_cast<T*>(memory);
+#else
+        return static_cast<T*>(::operator new(bytes, std::align_val_t(alignof(T))));
+#endif
+    }
+
+    void deallocate(T* pointer, size_t count) {
+        size_t bytes = count * sizeof(T);
+
+        if (!isMapped(bytes)) {
+            ::operator delete(pointer, std::align_val_t(alignof(T)));
+            return;
+        }
+
+#ifdef __linux__
+        munmap(pointer, mappedSize(bytes));
+#endif
+    }
+
+    // Memory is released by size alone, so any two instances can free each
+    // other's allocations as long as their min_size agrees.
+    template <typename U>
+    bool operator== (const CHugePageAllocator<U>& other) const {
+        return policy_.min_size == other.policy_.min_size;
+    }
+};
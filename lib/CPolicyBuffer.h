@@ -0,0 +1,367 @@
+#pragma once
+
+#include "CCircularBuffer.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+
+// What CPolicyBuffer does when an element is added to a full buffer.
+enum class COverflowPolicy {
+    // Drop the element at the opposite end, as CCircularBuffer does.
+    Overwrite,
+    // Leave the buffer unchanged and report failure.
+    Reject,
+    // Wait until another thread removes an element. All operations that
+    // change the buffer are then synchronized.
+    Block,
+    // Double the capacity, as CCircularBufferExp does.
+    Grow
+};
+
+// Circular buffer with the full-buffer behaviour chosen at compile time.
+// Unlike the CCircularBuffer / CCircularBufferExp hierarchy there are no
+// virtual functions: push_back, push_front and insert are plain inline
+// members whose policy branch is resolved by if constexpr, so each policy
+// compiles to its own specialized hot path.
+//
+// Storage uses the same begin_ / end_ scheme over capacity_ + 1 slots as
+// CCircularBuffer and hands out the same Iterator type.
+template <typename T, COverflowPolicy Policy = COverflowPolicy::Overwrite, typename Allocator = std::allocator<T>>
+class CPolicyBuffer {
+    using AllocatorTraits = std::allocator_traits<Allocator>;
+
+    static constexpr bool kBlocking = Policy == COverflowPolicy::Block;
+
+    struct Sync {
+        std::mutex mutex;
+        std::condition_variable not_full;
+        // Front elements removed so far, to keep an insert position while
+        // waiting for room.
+        uint64_t popped = 0;
+    };
+
+    struct NoSync {};
+
+    struct NoLock {};
+
+    // Held for the duration of an operation under Block, empty otherwise.
+    using Lock = std::conditional_t<kBlocking, std::unique_lock<std::mutex>, NoLock>;
+
+    T* buffer_;
+    size_t size_;
+    size_t begin_;
+    size_t end_;
+    size_t capacity_;
+    Allocator allocator_;
+    [[no_unique_address]] std::conditional_t<kBlocking, Sync, NoSync> sync_;
+
+    constexpr T* allocate(size_t count) {
+        return CSlotStorage<T, Allocator>::allocate(allocator_, count);
+    }
+
+    constexpr void deallocate(T* storage, size_t count) {
+        CSlotStorage<T, Allocator>::deallocate(allocator_, storage, count);
+    }
+
+    constexpr Lock lock() {
+        if constexpr (kBlocking) {
+            return std::unique_lock<std::mutex>(sync_.mutex);
+        } else {
+            return NoLock();
+        }
+    }
+
+    [[nodiscard]] constexpr size_t physical(size_t index) const {
+        return (begin_ + index) % (capacity_ + 1);
+    }
+
+    constexpr void grow() {
+        size_t new_capacity = capacity_ == 0 ? 1 : capacity_ * 2;
+        T* new_buffer = allocate(new_capacity + 1);
+
+        for (size_t i = 0; i < size_; i++) {
+            new_buffer[i] = buffer_[physical(i)];
+        }
+
+        deallocate(buffer_, capacity_ + 1);
+        buffer_ = new_buffer;
+        begin_ = 0;
+        end_ = size_;
+        capacity_ = new_capacity;
+    }
+
+    // Makes room for one more element according to the policy. Returns false
+    // if the element must not be added. For Overwrite it also reports, via
+    // overwrite, that the caller has to drop an element to make room.
+    constexpr bool reserve([[maybe_unused]] Lock& lock, bool& overwrite) {
+        overwrite = false;
+
+        if (size_ != capacity_) {
+            return true;
+        }
+
+        if constexpr (Policy == COverflowPolicy::Overwrite) {
+            overwrite = true;
+            return capacity_ != 0;
+        } else if constexpr (Policy == COverflowPolicy::Reject) {
+            return false;
+        } else if constexpr (Policy == COverflowPolicy::Block) {
+            if (capacity_ == 0) {
+                return false;
+            }
+
+            sync_.not_full.wait(lock, [this]() { return size_ != capacity_; });
+            return true;
+        } else {
+            grow();
+            return true;
+        }
+    }
+
+    constexpr void notifyNotFull() {
+        if constexpr (kBlocking) {
+            sync_.not_full.notify_all();
+        }
+    }
+
+    constexpr void popFront() {
+        begin_ = physical(1);
+        size_--;
+
+        if constexpr (kBlocking) {
+            sync_.popped++;
+        }
+
+        notifyNotFull();
+    }
+
+    constexpr void popBack() {
+        end_ = (end_ + capacity_) % (capacity_ + 1);
+        size_--;
+        notifyNotFull();
+    }
+
+public:
+    using Iterator = typename CCircularBuffer<T, Allocator>::Iterator;
+
+    constexpr explicit CPolicyBuffer(const Allocator& allocator = Allocator())
+            : buffer_(nullptr), size_(0), begin_(0), end_(0), capacity_(0), allocator_(allocator) {};
+
+    constexpr explicit CPolicyBuffer(size_t buffer_size, const Allocator& allocator = Allocator())
+            : size_(0), begin_(0), end_(0), capacity_(buffer_size), allocator_(allocator) {
+        buffer_ = allocate(capacity_ + 1);
+    }
+
+    constexpr CPolicyBuffer(const CPolicyBuffer& other)
+            : size_(other.size_), begin_(other.begin_), end_(other.end_), capacity_(other.capacity_),
+              allocator_(AllocatorTraits::select_on_container_copy_construction(other.allocator_)) {
+        buffer_ = allocate(capacity_ + 1);
+
+        for (size_t i = 0; i < size_; i++) {
+            buffer_[physical(i)] = other.buffer_[physical(i)];
+        }
+    }
+
+    constexpr CPolicyBuffer& operator= (const CPolicyBuffer& other) {
+        if (this != &other) {
+            deallocate(buffer_, capacity_ + 1);
+            size_ = other.size_;
+            begin_ = other.begin_;
+            end_ = other.end_;
+            capacity_ = other.capacity_;
+            buffer_ = allocate(capacity_ + 1);
+
+            for (size_t i = 0; i < size_; i++) {
+                buffer_[physical(i)] = other.buffer_[physical(i)];
+            }
+        }
+
+        return *this;
+    }
+
+    constexpr ~CPolicyBuffer() {
+        deallocate(buffer_, capacity_ + 1);
+    }
+
+    constexpr T& operator[] (size_t num) {
+        return buffer_[physical(num)];
+    }
+
+    constexpr const T& operator[] (size_t num) const {
+        return buffer_[physical(num)];
+    }
+
+    // Returns whether value was added; only Reject (and any policy on a
+    // buffer of capacity 0 that cannot grow) ever returns false.
+    constexpr bool push_back(const T& value) {
+        [[maybe_unused]] Lock guard = lock();
+        bool overwrite;
+
+        if (!reserve(guard, overwrite)) {
+            return false;
+        }
+
+        buffer_[end_] = value;
+        end_ = (end_ + 1) % (capacity_ + 1);
+
+        if (overwrite) {
+            begin_ = physical(1);
+        } else {
+            size_++;
+        }
+
+        return true;
+    }
+
+    constexpr bool push_front(const T& value) {
+        [[maybe_unused]] Lock guard = lock();
+        bool overwrite;
+
+        if (!reserve(guard, overwrite)) {
+            return false;
+        }
+
+        begin_ = (begin_ + capacity_) % (capacity_ + 1);
+        buffer_[begin_] = value;
+
+        if (overwrite) {
+            end_ = (end_ + capacity_) % (capacity_ + 1);
+        } else {
+            size_++;
+        }
+
+        return true;
+    }
+
+    // Inserts value before pointer. On a full Overwrite buffer the front
+    // element is dropped first. Under Block, front elements popped while
+    // waiting for room move the position along with the remaining ones.
+    // Returns an iterator to the inserted element, or end() if it was
+    // rejected.
+    constexpr Iterator insert(const Iterator& pointer, const T& value) {
+        [[maybe_unused]] Lock guard = lock();
+        size_t index = pointer - begin();
+        bool overwrite;
+
+        if constexpr (kBlocking) {
+            uint64_t popped = sync_.popped;
+
+            if (!reserve(guard, overwrite)) {
+                return end();
+            }
+
+            uint64_t gone = sync_.popped - popped;
+            index = std::min<size_t>(index - std::min<uint64_t>(index, gone), size_);
+        } else if (!reserve(guard, overwrite)) {
+            return end();
+        }
+
+        if (overwrite) {
+            begin_ = physical(1);
+            size_--;
+
+            if (index != 0) {
+                index--;
+            }
+        }
+
+        end_ = (end_ + 1) % (capacity_ + 1);
+        size_++;
+
+        for (size_t i = size_ - 1; i > index; i--) {
+            buffer_[physical(i)] = buffer_[physical(i - 1)];
+        }
+        buffer_[physical(index)] = value;
+
+        return Iterator(buffer_, capacity_, index, begin_);
+    }
+
+    constexpr Iterator erase(const Iterator& pointer) {
+        [[maybe_unused]] Lock guard = lock();
+        size_t index = pointer - begin();
+
+        if (index >= size_) {
+            return end();
+        }
+
+        for (size_t i = index; i + 1 < size_; i++) {
+            buffer_[physical(i)] = buffer_[physical(i + 1)];
+        }
+        popBack();
+
+        return Iterator(buffer_, capacity_, index, begin_);
+    }
+
+    constexpr void pop_back() {
+        [[maybe_unused]] Lock guard = lock();
+
+        if (size_ != 0) {
+            popBack();
+        }
+    }
+
+    constexpr void pop_front() {
+        [[maybe_unused]] Lock guard = lock();
+
+        if (size_ != 0) {
+            popFront();
+        }
+    }
+
+    // Moves the front element into value and removes it in one step, which
+    // is what a consumer of a Block buffer needs. Returns false if empty.
+    constexpr bool try_pop_front(T& value) {
+        [[maybe_unused]] Lock guard = lock();
+
+        if (size_ == 0) {
+            return false;
+        }
+
+        value = buffer_[begin_];
+        popFront();
+        return true;
+    }
+
+    constexpr void clear() {
+        [[maybe_unused]] Lock guard = lock();
+        size_ = 0;
+        begin_ = end_ = 0;
+        notifyNotFull();
+    }
+
+    [[nodiscard]] constexpr Iterator begin() const {
+        return Iterator(buffer_, capacity_, 0, begin_);
+    }
+
+    [[nodiscard]] constexpr Iterator end() const {
+        return Iterator(buffer_, capacity_, size_, begin_);
+    }
+
+    [[nodiscard]] constexpr bool empty() const {
+        return size_ == 0;
+    }
+
+    [[nodiscard]] constexpr bool full() const {
+        return size_ == capacity_;
+    }
+
+    [[nodiscard]] constexpr size_t size() const {
+        return size_;
+    }
+
+    [[nodiscard]] constexpr size_t max_size() const {
+        return capacity_;
+    }
+
+    [[nodiscard]] constexpr T& front() {
+        return buffer_[begin_];
+    }
+
+    [[nodiscard]] constexpr T& back() {
+        return buffer_[(end_ + capacity_) % (capacity_ + 1)];
+    }
+};
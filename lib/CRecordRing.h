@@ -0,0 +1,218 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <span>
+#include <stdexcept>
+
+// Ring of variable-length byte records stored back to back in one byte
+// array, so a message costs no allocation of its own. Each record is a
+// 4-byte length followed by its bytes, padded to a multiple of 4.
+//
+// Like CCircularBuffer the ring is tracked by begin_ and end_ offsets.
+// A record never wraps around: when it does not fit before the end of the
+// array, the rest of the array is marked with a skip header and the record
+// starts again at offset 0. Every record is therefore one contiguous span,
+// and read hands that span out without copying. It stays valid until the
+// record is removed with pop_front or consume.
+class CRecordRing {
+    static constexpr size_t kHeaderSize = sizeof(uint32_t);
+    static constexpr uint32_t kSkip = UINT32_MAX;
+
+    char* buffer_;
+    size_t capacity_;
+    size_t begin_;
+    size_t end_;
+    // Bytes taken by records and the padding at the wrap point.
+    size_t used_;
+    size_t count_;
+
+    [[nodiscard]] static size_t recordSize(size_t length) {
+        return (kHeaderSize + length + kHeaderSize - 1) / kHeaderSize * kHeaderSize;
+    }
+
+    [[nodiscard]] uint32_t header(size_t offset) const {
+        uint32_t length;
+        std::memcpy(&length, buffer_ + offset, kHeaderSize);
+        return length;
+    }
+
+    [[nodiscard]] std::span<const char> record(size_t offset) const {
+        return {buffer_ + offset + kHeaderSize, header(offset)};
+    }
+
+    // Offset of the record following the one at offset, past any padding.
+    [[nodiscard]] size_t next(size_t offset) const {
+        offset += recordSize(header(offset));
+
+        if (offset == capacity_ || header(offset) == kSkip) {
+            return 0;
+        }
+
+        return offset;
+    }
+
+public:
+    // Forward iterator over the records in order, yielding their spans.
+    class Iterator {
+        const CRecordRing* ring_;
+        size_t offset_;
+        size_t remaining_;
+
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using difference_type = std::ptrdiff_t;
+        using value_type = std::span<const char>;
+        using pointer = void;
+        using reference = std::span<const char>;
+
+        Iterator() : ring_(nullptr), offset_(0), remaining_(0) {};
+        Iterator(const CRecordRing* ring, size_t offset, size_t remaining)
+                : ring_(ring), offset_(offset), remaining_(remaining) {};
+
+        reference operator*() const {
+            return ring_->record(offset_);
+        }
+
+        Iterator& operator++() {
+            remaining_--;
+
+            if (remaining_ != 0) {
+                offset_ = ring_->next(offset_);
+            }
+
+            return *this;
+        }
+
+        Iterator operator++(int) {
+            Iterator iterator = *this;
+            ++*this;
+            return iterator;
+        }
+
+        bool operator== (const Iterator& other) const {
+            return remaining_ == other.remaining_;
+        }
+    };
+
+    // buffer_size is rounded up to a multiple of 4 bytes.
+    explicit CRecordRing(size_t buffer_size)
+            : capacity_(recordSize(buffer_size) - kHeaderSize), begin_(0), end_(0), used_(0), count_(0) {
+        if (capacity_ == 0) {
+            throw std::invalid_argument("CRecordRing size must be positive");
+        }
+
+        buffer_ = new char[capacity_];
+    }
+
+    ~CRecordRing() {
+        delete[] buffer_;
+    }
+
+    CRecordRing(const CRecordRing& other) = delete;
+    CRecordRing& operator= (const CRecordRing& other) = delete;
+
+    // Appends data as one record. Returns false, leaving the ring unchanged,
+    // if there is no contiguous room for it.
+    bool try_write(std::span<const char> data) {
+        size_t need = recordSize(data.size());
+
+        if (data.size() >= kSkip || need > capacity_ - used_) {
+            return false;
+        }
+
+        if (end_ >= begin_) {
+            size_t tail = capacity_ - end_;
+
+            if (tail < need) {
+                if (begin_ < need) {
+                    return false;
+                }
+
+                std::memcpy(buffer_ + end_, &kSkip, kHeaderSize);
+                used_ += tail;
+                end_ = 0;
+            }
+        } else if (begin_ - end_ < need) {
+            return false;
+        }
+
+        auto length = static_cast<uint32_t>(data.size());
+        std::memcpy(buffer_ + end_, &length, kHeaderSize);
+        std::memcpy(buffer_ + end_ + kHeaderSize, data.data(), data.size());
+
+        end_ = (end_ + need) % capacity_;
+        used_ += need;
+        count_++;
+
+        return true;
+    }
+
+    // Oldest record, without removing it. The ring must not be empty.
+    [[nodiscard]] std::span<const char> read() const {
+        return record(begin_);
+    }
+
+    void pop_front() {
+        if (count_ == 0) {
+            return;
+        }
+
+        count_--;
+
+        if (count_ == 0) {
+            begin_ = end_ = used_ = 0;
+            return;
+        }
+
+        size_t next_begin = next(begin_);
+        used_ -= next_begin > begin_ ? next_begin - begin_ : capacity_ - begin_;
+        begin_ = next_begin;
+    }
+
+    // Passes up to max oldest records to callback in order and removes them.
+    // The span given to callback is valid only during the call. Returns the
+    // number of records consumed.
+    template <typename Callback>
+    size_t consume(size_t max, Callback callback) {
+        size_t consumed = 0;
+
+        while (consumed != max && count_ != 0) {
+            callback(read());
+            pop_front();
+            consumed++;
+        }
+
+        return consumed;
+    }
+
+    void clear() {
+        begin_ = end_ = used_ = count_ = 0;
+    }
+
+    [[nodiscard]] Iterator begin() const {
+        return Iterator(this, begin_, count_);
+    }
+
+    [[nodiscard]] Iterator end() const {
+        return Iterator(this, begin_, 0);
+    }
+
+    [[nodiscard]] bool empty() const {
+        return count_ == 0;
+    }
+
+    // Number of records.
+    [[nodiscard]] size_t size() const {
+        return count_;
+    }
+
+    [[nodiscard]] size_t bytes_used() const {
+        return used_;
+    }
+
+    [[nodiscard]] size_t max_size() const {
+        return capacity_;
+    }
+};
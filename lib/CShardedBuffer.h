@@ -0,0 +1,244 @@
+#pragma once
+
+#include "CCircularBuffer.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+
+// Set of CCircularBuffer shards, one per producer thread, drained by a single
+// consumer. Every shard sits on its own cache line with its own lock, so a
+// producer only ever touches the lock of its shard and never contends with
+// other producers; the consumer briefly takes each lock to move a batch out.
+// Like CCircularBuffer, a full shard overwrites its oldest element.
+template <typename T>
+class CShardedBuffer {
+    struct alignas(64) Shard {
+        std::mutex mutex;
+        CCircularBuffer<T> buffer;
+
+        explicit Shard(size_t capacity) : buffer(capacity) {};
+    };
+
+    Shard* shards_;
+    CCircularBuffer<T>* staging_;
+    size_t* heap_;
+    size_t shard_count_;
+    size_t shard_capacity_;
+    // Identifies this buffer in the per-thread shard cache of local_shard;
+    // unlike the address it is never reused by a later buffer.
+    uint64_t id_;
+    std::atomic<size_t> next_shard_;
+
+    inline static std::atomic<uint64_t> next_id_ = 0;
+
+    // Tops the staging buffer of every shard up to batch elements.
+    void collect(size_t batch) {
+        batch = std::min(batch, shard_capacity_);
+
+        for (size_t i = 0; i < shard_count_; i++) {
+            std::lock_guard<std::mutex> lock(shards_[i].mutex);
+            CCircularBuffer<T>& buffer = shards_[i].buffer;
+
+            while (!buffer.empty() && staging_[i].size() < batch) {
+                staging_[i].push_back(buffer[0]);
+                buffer.pop_front();
+            }
+        }
+    }
+
+public:
+    explicit CShardedBuffer(size_t shard_capacity,
+                            size_t shard_count = std::max(1u, std::thread::hardware_concurrency())) {
+        shard_count_ = std::max<size_t>(shard_count, 1);
+        shard_capacity_ = shard_capacity;
+        id_ = next_id_.fetch_add(1, std::memory_order_relaxed);
+        next_shard_ = 0;
+
+        shards_ = std::allocator<Shard>().allocate(shard_count_);
+        staging_ = std::allocator<CCircularBuffer<T>>().allocate(shard_count_);
+        heap_ = new size_t[shard_count_];
+
+        for (size_t i = 0; i < shard_count_; i++) {
+            std::construct_at(shards_ + i, shard_capacity_);
+            std::construct_at(staging_ + i, shard_capacity_);
+        }
+    }
+
+    ~CShardedBuffer() {
+        std::destroy_n(shards_, shard_count_);
+        std::destroy_n(staging_, shard_count_);
+        std::allocator<Shard>().deallocate(shards_, shard_count_);
+        std::allocator<CCircularBuffer<T>>().deallocate(staging_, shard_count_);
+        delete[] heap_;
+    }
+
+    CShardedBuffer(const CShardedBuffer& other) = delete;
+    CShardedBuffer& operator= (const CShardedBuffer& other) = delete;
+
+    // Hands out shards round-robin in order of registration. As long as no
+    // more than shard_count() producers register over the lifetime of the
+    // buffer, no two of them share a shard; shards of exited threads are not
+    // handed out again.
+    size_t register_producer() {
+        return next_shard_.fetch_add(1, std::memory_order_relaxed) % shard_count_;
+    }
+
+    // Shard of the calling thread in this buffer, registering the thread on
+    // its first call. Each thread caches only the buffer it pushed to last,
+    // so a thread alternating between buffers registers again on every
+    // switch; such a producer should keep the result of register_producer
+    // and push with push_back(shard, value) instead.
+    [[nodiscard]] size_t local_shard() {
+        struct Cached {
+            uint64_t id = UINT64_MAX;
+            size_t shard = 0;
+        };
+
+        static thread_local Cached cached;
+
+        if (cached.id != id_) {
+            cached = {id_, register_producer()};
+        }
+
+        return cached.shard;
+    }
+
+    void push_back(const T& value) {
+        push_back(local_shard(), value);
+    }
+
+    void push_back(size_t shard, const T& value) {
+        if (shard >= shard_count_) {
+            throw std::out_of_range("In function push_back shard is out of range");
+        }
+
+        std::lock_guard<std::mutex> lock(shards_[shard].mutex);
+        shards_[shard].buffer.push_back(value);
+    }
+
+    // Removes up to batch elements from every shard and passes them to
+    // callback shard by shard, together with any elements drain_ordered held
+    // back. Returns the number of drained elements.
+    template <typename Callback>
+    size_t drain(size_t batch, Callback callback) {
+        size_t count = 0;
+        collect(batch);
+
+        for (size_t i = 0; i < shard_count_; i++) {
+            while (!staging_[i].empty()) {
+                callback(staging_[i][0]);
+                staging_[i].pop_front();
+                count++;
+            }
+        }
+
+        return count;
+    }
+
+    // Same as drain, but elements are passed to callback ordered by
+    // projection (a sequence number or a timestamp) among all elements that
+    // were in the buffer when each call ran, produced by a k-way merge. Each
+    // shard must already be ordered by it. An element pushed later with a
+    // smaller key than one already passed on, e.g. to a shard that had
+    // nothing staged, comes out after it.
+    //
+    // A shard may still hold elements older than the last one it staged, so
+    // only elements up to the smallest such last key over the shards with
+    // staged elements are passed on. The rest stay staged for a later call;
+    // the shard with the smallest last key is always drained completely, so
+    // repeated calls flush everything. Returns the number of drained elements.
+    template <typename Callback, typename Projection = std::identity>
+    size_t drain_ordered(size_t batch, Callback callback, Projection projection = {}) {
+        size_t count = 0;
+        size_t heap_size = 0;
+        size_t watermark = shard_count_;
+        collect(batch);
+
+        auto last = [&](size_t shard) {
+            return std::invoke(projection, staging_[shard][staging_[shard].size() - 1]);
+        };
+
+        auto greater = [&](size_t lhs, size_t rhs) {
+            return std::invoke(projection, staging_[rhs][0]) < std::invoke(projection, staging_[lhs][0]);
+        };
+
+        for (size_t i = 0; i < shard_count_; i++) {
+            if (!staging_[i].empty()) {
+                heap_[heap_size++] = i;
+
+                if (watermark == shard_count_ || last(i) < last(watermark)) {
+                    watermark = i;
+                }
+            }
+        }
+
+        if (heap_size == 0) {
+            return 0;
+        }
+
+        auto limit = last(watermark);
+        std::make_heap(heap_, heap_ + heap_size, greater);
+
+        while (heap_size != 0) {
+            std::pop_heap(heap_, heap_ + heap_size, greater);
+            size_t shard = heap_[heap_size - 1];
+
+            if (limit < std::invoke(projection, staging_[shard][0])) {
+                break;
+            }
+
+            callback(staging_[shard][0]);
+            staging_[shard].pop_front();
+            count++;
+
+            if (staging_[shard].empty()) {
+                heap_size--;
+            } else {
+                std::push_heap(heap_, heap_ + heap_size, greater);
+            }
+        }
+
+        return count;
+    }
+
+    // Elements in the shards, not counting those drain_ordered held back.
+    [[nodiscard]] size_t size() {
+        size_t result = 0;
+
+        for (size_t i = 0; i < shard_count_; i++) {
+            std::lock_guard<std::mutex> lock(shards_[i].mutex);
+            result += shards_[i].buffer.size();
+        }
+
+        return result;
+    }
+
+    [[nodiscard]] bool empty() {
+        return size() == 0;
+    }
+
+    // Elements drain_ordered held back for a later call. Consumer only.
+    [[nodiscard]] size_t staged() const {
+        size_t result = 0;
+
+        for (size_t i = 0; i < shard_count_; i++) {
+            result += staging_[i].size();
+        }
+
+        return result;
+    }
+
+    [[nodiscard]] size_t shard_count() const {
+        return shard_count_;
+    }
+
+    [[nodiscard]] size_t shard_capacity() const {
+        return shard_capacity_;
+    }
+};
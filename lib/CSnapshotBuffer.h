@@ -0,0 +1,320 @@
+#pragma once
+
+#include <atomic>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+
+// Fixed-capacity circular buffer (overwriting the oldest element when full,
+// like CCircularBuffer) whose storage is split into reference-counted chunks.
+// snapshot() is O(1): it shares the chunk table with the buffer, and the
+// writer copies the table and then only the chunks it modifies, on its first
+// write to each of them after a snapshot was taken.
+//
+// The buffer itself has a single writer, and snapshot() is a writer-side
+// operation: it reads the table without synchronization, so it must be
+// called on the writer thread (or with the writer otherwise excluded).
+// Reporting threads do not call it themselves; they are handed snapshots,
+// which are immutable and may be read and destroyed from any thread.
+template <typename T, size_t ChunkSize = 1024>
+class CSnapshotBuffer {
+    struct Chunk {
+        T values[ChunkSize];
+    };
+
+    using ChunkPtr = std::shared_ptr<Chunk>;
+
+    struct Table {
+        ChunkPtr* chunks;
+        size_t count;
+
+        explicit Table(size_t chunk_count) : chunks(new ChunkPtr[chunk_count]), count(chunk_count) {
+            for (size_t i = 0; i < count; i++) {
+                chunks[i] = std::make_shared<Chunk>();
+            }
+        }
+
+        Table(const Table& other) : chunks(new ChunkPtr[other.count]), count(other.count) {
+            for (size_t i = 0; i < count; i++) {
+                chunks[i] = other.chunks[i];
+            }
+        }
+
+        Table& operator= (const Table& other) = delete;
+
+        ~Table() {
+            delete[] chunks;
+        }
+
+        [[nodiscard]] const T& at(size_t physical) const {
+            return chunks[physical / ChunkSize]->values[physical % ChunkSize];
+        }
+    };
+
+    std::shared_ptr<Table> table_;
+    size_t size_;
+    size_t begin_;
+    size_t end_;
+    size_t capacity_;
+
+    [[nodiscard]] size_t physical(size_t index) const {
+        return (begin_ + index) % (capacity_ + 1);
+    }
+
+    // Slot for the writer; unshares the table and the chunk first if a
+    // snapshot still references them. Other owners can only drop their
+    // references, so a use_count of one means exclusive ownership.
+    T& writable(size_t physical) {
+        if (table_.use_count() != 1) {
+            table_ = std::make_shared<Table>(*table_);
+        }
+
+        ChunkPtr& chunk = table_->chunks[physical / ChunkSize];
+
+        if (chunk.use_count() != 1) {
+            chunk = std::make_shared<Chunk>(*chunk);
+        }
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+
+        return chunk->values[physical % ChunkSize];
+    }
+
+public:
+    class Iterator {
+        const Table* table_;
+        size_t capacity_;
+        size_t begin_;
+        size_t index_;
+
+    public:
+        using iterator_category = std::random_access_iterator_tag;
+        using difference_type = std::ptrdiff_t;
+        using value_type = T;
+        using pointer = const T*;
+        using reference = const T&;
+
+        Iterator() : table_(nullptr), capacity_(0), begin_(0), index_(0) {};
+        Iterator(const Table* table, size_t capacity, size_t begin, size_t index)
+                : table_(table), capacity_(capacity), begin_(begin), index_(index) {};
+
+        reference operator*() const {
+            return table_->at((begin_ + index_) % (capacity_ + 1));
+        }
+
+        pointer operator->() const {
+            return &**this;
+        }
+
+        reference operator[](difference_type num) const {
+            return *(*this + num);
+        }
+
+        Iterator& operator++() {
+            index_++;
+            return *this;
+        }
+
+        Iterator operator++(int) {
+            Iterator iterator = *this;
+            index_++;
+            return iterator;
+        }
+
+        Iterator& operator--() {
+            index_--;
+            return *this;
+        }
+
+        Iterator operator--(int) {
+            Iterator iterator = *this;
+            index_--;
+            return iterator;
+        }
+
+        Iterator& operator+= (difference_type num) {
+            index_ += num;
+            return *this;
+        }
+
+        Iterator& operator-= (difference_type num) {
+            index_ -= num;
+            return *this;
+        }
+
+        Iterator operator+ (difference_type num) const {
+            Iterator iterator = *this;
+            iterator += num;
+            return iterator;
+        }
+
+        friend Iterator operator+ (difference_type num, const Iterator& iterator) {
+            return iterator + num;
+        }
+
+        Iterator operator- (difference_type num) const {
+            Iterator iterator = *this;
+            iterator -= num;
+            return iterator;
+        }
+
+        difference_type operator- (const Iterator& other) const {
+            return static_cast<difference_type>(index_) - static_cast<difference_type>(other.index_);
+        }
+
+        bool operator== (const Iterator& other) const {
+            return index_ == other.index_;
+        }
+
+        auto operator<=> (const Iterator& other) const {
+            return index_ <=> other.index_;
+        }
+    };
+
+    // Read-only view of the buffer at the moment snapshot() was called.
+    class Snapshot {
+        std::shared_ptr<const Table> table_;
+        size_t size_;
+        size_t begin_;
+        size_t capacity_;
+
+    public:
+        Snapshot() : size_(0), begin_(0), capacity_(0) {};
+        Snapshot(std::shared_ptr<const Table> table, size_t size, size_t begin, size_t capacity)
+                : table_(std::move(table)), size_(size), begin_(begin), capacity_(capacity) {};
+
+        const T& operator[] (size_t num) const {
+            return table_->at((begin_ + num) % (capacity_ + 1));
+        }
+
+        [[nodiscard]] Iterator begin() const {
+            return Iterator(table_.get(), capacity_, begin_, 0);
+        }
+
+        [[nodiscard]] Iterator end() const {
+            return Iterator(table_.get(), capacity_, begin_, size_);
+        }
+
+        [[nodiscard]] Iterator cbegin() const {
+            return begin();
+        }
+
+        [[nodiscard]] Iterator cend() const {
+            return end();
+        }
+
+        [[nodiscard]] bool empty() const {
+            return size_ == 0;
+        }
+
+        [[nodiscard]] size_t size() const {
+            return size_;
+        }
+
+        [[nodiscard]] const T& front() const {
+            return (*this)[0];
+        }
+
+        [[nodiscard]] const T& back() const {
+            return (*this)[size_ - 1];
+        }
+    };
+
+    explicit CSnapshotBuffer(size_t buffer_size) {
+        size_ = 0;
+        begin_ = end_ = 0;
+        capacity_ = buffer_size;
+        table_ = std::make_shared<Table>((capacity_ + ChunkSize) / ChunkSize);
+    }
+
+    // Copies share storage exactly like snapshots do.
+    CSnapshotBuffer(const CSnapshotBuffer& other) = default;
+    CSnapshotBuffer& operator= (const CSnapshotBuffer& other) = default;
+
+    // Writer thread only; pass the result to readers.
+    [[nodiscard]] Snapshot snapshot() const {
+        return Snapshot(table_, size_, begin_, capacity_);
+    }
+
+    const T& operator[] (size_t num) const {
+        return table_->at(physical(num));
+    }
+
+    void set(size_t num, const T& value) {
+        if (num >= size_) {
+            throw std::out_of_range("In function set index is out of range");
+        }
+
+        writable(physical(num)) = value;
+    }
+
+    void push_back(const T& value) {
+        writable(end_) = value;
+        end_ = (end_ + 1) % (capacity_ + 1);
+
+        if (begin_ == end_) {
+            begin_ = (begin_ + 1) % (capacity_ + 1);
+        } else {
+            size_++;
+        }
+    }
+
+    void push_front(const T& value) {
+        begin_ = (begin_ + capacity_) % (capacity_ + 1);
+
+        if (begin_ == end_) {
+            end_ = (end_ + capacity_) % (capacity_ + 1);
+        } else {
+            size_++;
+        }
+
+        writable(begin_) = value;
+    }
+
+    void pop_back() {
+        if (!empty()) {
+            size_--;
+            end_ = (end_ + capacity_) % (capacity_ + 1);
+        }
+    }
+
+    void pop_front() {
+        if (!empty()) {
+            size_--;
+            begin_ = (begin_ + 1) % (capacity_ + 1);
+        }
+    }
+
+    void clear() {
+        size_ = 0;
+        begin_ = end_ = 0;
+    }
+
+    [[nodiscard]] Iterator begin() const {
+        return Iterator(table_.get(), capacity_, begin_, 0);
+    }
+
+    [[nodiscard]] Iterator end() const {
+        return Iterator(table_.get(), capacity_, begin_, size_);
+    }
+
+    [[nodiscard]] bool empty() const {
+        return size_ == 0;
+    }
+
+    [[nodiscard]] size_t size() const {
+        return size_;
+    }
+
+    [[nodiscard]] size_t max_size() const {
+        return capacity_;
+    }
+
+    [[nodiscard]] const T& front() const {
+        return (*this)[0];
+    }
+
+    [[nodiscard]] const T& back() const {
+        return (*this)[size_ - 1];
+    }
+};
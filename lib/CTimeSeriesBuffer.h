@@ -0,0 +1,137 @@
+#pragma once
+
+#include "CCircularBuffer.h"
+
+#include <algorithm>
+#include <functional>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+// Circular buffer whose elements are appended in non-decreasing order of a
+// timestamp projection. Because the live data is at most two sorted physical
+// segments, range lookups and age eviction are binary searches over raw
+// storage instead of scans through Iterator.
+//
+// push_back, push_front and insert reject elements out of order. Elements
+// changed through operator[] or Iterator must keep their timestamps.
+template <typename T, typename Projection = std::identity>
+class CTimeSeriesBuffer final : public CCircularBuffer<T> {
+    using CCircularBuffer<T>::buffer_;
+    using CCircularBuffer<T>::size_;
+    using CCircularBuffer<T>::begin_;
+    using CCircularBuffer<T>::end_;
+    using CCircularBuffer<T>::capacity_;
+
+    Projection projection_;
+
+public:
+    using Iterator = CCircularBuffer<T>::Iterator;
+    using Key = std::remove_cvref_t<std::invoke_result_t<Projection&, const T&>>;
+    using Segments = std::pair<std::span<T>, std::span<T>>;
+
+    CTimeSeriesBuffer() : CCircularBuffer<T>() {};
+    explicit CTimeSeriesBuffer(size_t buffer_size, Projection projection = {})
+            : CCircularBuffer<T>(buffer_size), projection_(std::move(projection)) {};
+
+    void push_back(const T& value) override {
+        if (size_ != 0 && key(value) < key(buffer_[physical(size_ - 1)])) {
+            throw std::invalid_argument("In function push_back timestamp is older than the last element");
+        }
+
+        CCircularBuffer<T>::push_back(value);
+    }
+
+    void push_front(const T& value) override {
+        if (size_ != 0 && key(buffer_[begin_]) < key(value)) {
+            throw std::invalid_argument("In function push_front timestamp is newer than the first element");
+        }
+
+        CCircularBuffer<T>::push_front(value);
+    }
+
+    // Inserting keeps the order too: value must not be older than the element
+    // before pointer nor newer than the one at pointer.
+    Iterator insert(Iterator& pointer, const T& value) override {
+        size_t index = pointer - this->begin();
+
+        if (index != 0 && index <= size_ && key(value) < key(buffer_[physical(index - 1)])) {
+            throw std::invalid_argument("In function insert timestamp is older than the previous element");
+        }
+
+        if (index < size_ && key(buffer_[physical(index)]) < key(value)) {
+            throw std::invalid_argument("In function insert timestamp is newer than the next element");
+        }
+
+        return CCircularBuffer<T>::insert(pointer, value);
+    }
+
+    // Elements with from <= timestamp < to, as at most two contiguous spans
+    // in logical order. The second span is empty unless the range wraps.
+    Segments range(const Key& from, const Key& to) {
+        size_t first = lowerBound(from);
+        size_t last = std::max(first, lowerBound(to));
+
+        return segments(first, last);
+    }
+
+    // Drops every element with timestamp < time by moving begin_ once.
+    // Returns the number of evicted elements.
+    size_t evict_before(const Key& time) {
+        size_t count = lowerBound(time);
+
+        begin_ = physical(count);
+        size_ -= count;
+
+        return count;
+    }
+
+    [[nodiscard]] Segments segments() {
+        return segments(0, size_);
+    }
+
+private:
+    [[nodiscard]] Key key(const T& value) {
+        return std::invoke(projection_, value);
+    }
+
+    [[nodiscard]] size_t physical(size_t index) const {
+        return (begin_ + index) % (capacity_ + 1);
+    }
+
+    // Length of the first physical segment, starting at begin_.
+    [[nodiscard]] size_t firstLength() const {
+        return std::min(size_, capacity_ + 1 - begin_);
+    }
+
+    // Logical index of the first element with timestamp >= time.
+    size_t lowerBound(const Key& time) {
+        size_t first_length = firstLength();
+        T* first = buffer_ + begin_;
+
+        if (first_length != 0 && !(key(first[first_length - 1]) < time)) {
+            return std::ranges::lower_bound(first, first + first_length, time, {}, projection_) - first;
+        }
+
+        T* second = buffer_;
+        size_t second_length = size_ - first_length;
+
+        return first_length + (std::ranges::lower_bound(second, second + second_length, time, {}, projection_) - second);
+    }
+
+    Segments segments(size_t first, size_t last) {
+        size_t first_length = firstLength();
+
+        if (last <= first_length) {
+            return {std::span<T>(buffer_ + begin_ + first, last - first), std::span<T>()};
+        }
+
+        if (first >= first_length) {
+            return {std::span<T>(buffer_ + (first - first_length), last - first), std::span<T>()};
+        }
+
+        return {std::span<T>(buffer_ + begin_ + first, first_length - first),
+                std::span<T>(buffer_, last - first_length)};
+    }
+};
@@ -0,0 +1,157 @@
+#include "../lib/CBroadcastBuffer.h"
+
+#include <gtest/gtest.h>
+
+#include <thread>
+#include <vector>
+
+TEST(BroadcastTests, EveryReaderSeesEverything) {
+    CBroadcastBuffer<int> buffer(4, 2);
+    buffer.push_back(1);
+    buffer.push_back(2);
+    buffer.push_back(3);
+
+    std::vector<int> first;
+    std::vector<int> second;
+    ASSERT_EQ(buffer.consume(0, 10, [&](int value) { first.push_back(value); }), 3);
+    ASSERT_EQ(buffer.consume(1, 2, [&](int value) { second.push_back(value); }), 2);
+    ASSERT_EQ(buffer.available(1), 1);
+    ASSERT_EQ(buffer.consume(1, 2, [&](int value) { second.push_back(value); }), 1);
+
+    std::vector<int> vector = {1, 2, 3};
+    ASSERT_EQ(first, vector);
+    ASSERT_EQ(second, vector);
+    ASSERT_THROW(buffer.claim(2), std::out_of_range);
+}
+
+TEST(BroadcastTests, GateOnSlowestReader) {
+    CBroadcastBuffer<int> buffer(3, 2);
+    ASSERT_TRUE(buffer.try_push(1));
+    ASSERT_TRUE(buffer.try_push(2));
+    ASSERT_TRUE(buffer.try_push(3));
+    ASSERT_FALSE(buffer.try_push(4));
+
+    buffer.consume(0, 3, [](int) {});
+    ASSERT_FALSE(buffer.try_push(4));
+
+    auto range = buffer.claim(1, 2);
+    ASSERT_EQ(range.size(), 2);
+    ASSERT_EQ(buffer[range.begin], 1);
+    ASSERT_EQ(buffer[range.begin + 1], 2);
+    ASSERT_TRUE(buffer.release(1, range));
+
+    int values[] = {4, 5, 6};
+    ASSERT_EQ(buffer.try_push(values, 3), 2);
+    ASSERT_EQ(buffer.published(), 5);
+    ASSERT_EQ(buffer.lost(1), 0);
+}
+
+TEST(BroadcastTests, OverwriteDetectsGap) {
+    CBroadcastBuffer<int, CBroadcastMode::Overwrite> buffer(4, 1);
+    for (int i = 0; i < 10; i++) {
+        ASSERT_TRUE(buffer.try_push(i));
+    }
+
+    auto range = buffer.claim(0);
+    ASSERT_EQ(range.lost, 6);
+    ASSERT_EQ(range.size(), 4);
+    ASSERT_EQ(buffer[range.begin], 6);
+    ASSERT_TRUE(buffer.release(0, range));
+
+    buffer.push_back(10);
+    range = buffer.claim(0);
+    buffer.push_back(11);
+    buffer.push_back(12);
+    buffer.push_back(13);
+    buffer.push_back(14);
+    ASSERT_FALSE(buffer.release(0, range));
+    ASSERT_EQ(buffer.lost(0), 7);
+
+    std::vector<int> result;
+    buffer.consume(0, 10, [&](int value) { result.push_back(value); });
+    ASSERT_EQ(result, std::vector<int>({11, 12, 13, 14}));
+    ASSERT_EQ(buffer.lost(0), 7);
+
+    range = buffer.claim(0);
+    for (int i = 15; i < 22; i++) {
+        buffer.push_back(i);
+    }
+    ASSERT_EQ(range.size(), 0);
+    ASSERT_TRUE(buffer.release(0, range));
+
+    range = buffer.claim(0, 2);
+    ASSERT_EQ(range.lost, 3);
+    for (int i = 22; i < 30; i++) {
+        buffer.push_back(i);
+    }
+    ASSERT_FALSE(buffer.release(0, range));
+    ASSERT_EQ(buffer.lost(0), 7 + 3 + 2);
+}
+
+TEST(BroadcastTests, ConcurrentGate) {
+    const int count = 100000;
+    const size_t readers = 3;
+    CBroadcastBuffer<int> buffer(64, readers);
+
+    std::vector<std::thread> threads;
+    std::vector<long long> sums(readers, 0);
+    std::vector<char> ordered(readers, 1);
+
+    for (size_t r = 0; r < readers; r++) {
+        threads.emplace_back([&, r]() {
+            int expected = 0;
+            while (expected != count) {
+                buffer.consume(r, 16, [&](int value) {
+                    ordered[r] = ordered[r] && value == expected;
+                    sums[r] += value;
+                    expected++;
+                });
+            }
+        });
+    }
+
+    for (int i = 0; i < count; i++) {
+        buffer.push_back(i);
+    }
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    for (size_t r = 0; r < readers; r++) {
+        ASSERT_TRUE(ordered[r]);
+        ASSERT_EQ(sums[r], 1LL * count * (count - 1) / 2);
+    }
+}
+
+TEST(BroadcastTests, ConcurrentOverwrite) {
+    const int count = 200000;
+    CBroadcastBuffer<long long, CBroadcastMode::Overwrite> buffer(32, 1);
+
+    std::atomic<bool> done = false;
+    long long received = 0;
+    bool increasing = true;
+
+    std::thread reader([&]() {
+        long long last = -1;
+        auto callback = [&](long long value) {
+            increasing = increasing && value > last;
+            last = value;
+            received++;
+        };
+
+        while (!done.load()) {
+            buffer.consume(0, 8, callback);
+        }
+        while (buffer.consume(0, 8, callback) != 0) {}
+    });
+
+    for (long long i = 0; i < count; i++) {
+        buffer.push_back(i);
+    }
+    done = true;
+    reader.join();
+
+    ASSERT_TRUE(increasing);
+    ASSERT_EQ(received + static_cast<long long>(buffer.lost(0)), count);
+}
@@ -250,3 +250,77 @@ TEST(STLExpTest, STL) {
 
     ASSERT_TRUE(std::equal(buffer.begin(), buffer.end(), vector.begin(), vector.end()));
 }
+
+constexpr bool ConstexprExpGrowth() {
+    CCircularBufferExp<int> buffer(2);
+    for (int i = 1; i <= 5; i++) {
+        buffer.push_back(i);
+    }
+    buffer.push_front(0);
+
+    auto it = buffer.begin() + 3;
+    buffer.insert(it, 7);
+
+    int vector[] = {0, 1, 2, 7, 3, 4, 5};
+    return buffer.size() == 7 && buffer.max_size() == 8 && std::equal(buffer.begin(), buffer.end(), vector, vector + 7);
+}
+
+constexpr bool ConstexprExpWrapAround() {
+    CCircularBufferExp<int> buffer(3);
+    buffer.push_back(1);
+    buffer.push_back(2);
+    buffer.pop_front();
+    buffer.pop_front();
+    for (int i = 3; i <= 6; i++) {
+        buffer.push_back(i);
+    }
+
+    int vector[] = {3, 4, 5, 6};
+    return buffer.max_size() == 6 && std::equal(buffer.begin(), buffer.end(), vector, vector + 4);
+}
+
+TEST(ConstexprExpTests, Constexpr) {
+    static_assert(ConstexprExpGrowth());
+    static_assert(ConstexprExpWrapAround());
+
+    ASSERT_TRUE(ConstexprExpGrowth());
+}
+
+TEST(LinearizeExpTests, LinearizeAfterGrowth) {
+    CCircularBufferExp<int> buffer(3);
+    buffer.push_back(1);
+    buffer.push_back(2);
+    buffer.pop_front();
+    buffer.push_back(3);
+    buffer.push_back(4);
+    ASSERT_FALSE(buffer.is_linearized());
+
+    auto span = buffer.linearize();
+    std::vector<int> vector = {2, 3, 4};
+    ASSERT_TRUE(std::equal(span.begin(), span.end(), vector.begin(), vector.end()));
+
+    buffer.push_back(5);
+    buffer.push_back(6);
+    vector = {2, 3, 4, 5, 6};
+    ASSERT_EQ(buffer.max_size(), 6);
+    ASSERT_TRUE(std::equal(buffer.begin(), buffer.end(), vector.begin(), vector.end()));
+}
+
+TEST(ConsumeBatchExpTests, AfterGrowth) {
+    CCircularBufferExp<int> buffer(2);
+    buffer.push_back(1);
+    buffer.push_back(2);
+    buffer.pop_front();
+    buffer.push_back(3);
+    buffer.push_back(4);
+    buffer.push_back(5);
+
+    std::vector<int> consumed;
+    ASSERT_EQ(buffer.consume_batch(3, [&](int value) { consumed.push_back(value); }), 3);
+    std::vector<int> vector = {2, 3, 4};
+    ASSERT_EQ(consumed, vector);
+
+    buffer.push_back(6);
+    vector = {5, 6};
+    ASSERT_TRUE(std::equal(buffer.begin(), buffer.end(), vector.begin(), vector.end()));
+}
@@ -249,4 +249,182 @@ TEST(STLTest, STL) {
     ASSERT_TRUE(std::equal(buffer.begin(), buffer.end(), vector.begin(), vector.end()));
 }
 
+constexpr bool ConstexprWrapAround() {
+    CCircularBuffer<int> buffer(3);
+    for (int i = 1; i <= 5; i++) {
+        buffer.push_back(i);
+    }
+
+    int vector[] = {3, 4, 5};
+    return buffer.size() == 3 && std::equal(buffer.begin(), buffer.end(), vector, vector + 3);
+}
+
+constexpr bool ConstexprPushPop() {
+    CCircularBuffer<int> buffer(3);
+    buffer.push_front(3);
+    buffer.push_front(2);
+    buffer.push_front(1);
+    buffer.push_front(0);
+    buffer.pop_back();
+    buffer.push_back(9);
+    buffer.pop_front();
+
+    int vector[] = {1, 9};
+    return std::equal(buffer.begin(), buffer.end(), vector, vector + 2);
+}
+
+constexpr bool ConstexprInsertErase() {
+    CCircularBuffer<int> buffer(5);
+    buffer.push_back(1);
+    buffer.push_back(3);
+    buffer.push_back(4);
+    buffer.push_back(5);
+
+    auto it = buffer.begin() + 1;
+    buffer.insert(it, 2);
+
+    auto first = buffer.begin() + 1;
+    auto last = buffer.end() - 1;
+    buffer.erase(first, last);
+
+    CCircularBuffer<int> copy(buffer);
+    int vector[] = {1, 5};
+    return copy == buffer && std::equal(copy.begin(), copy.end(), vector, vector + 2);
+}
+
+TEST(ConstexprTests, Constexpr) {
+    static_assert(ConstexprWrapAround());
+    static_assert(ConstexprPushPop());
+    static_assert(ConstexprInsertErase());
+
+    ASSERT_TRUE(ConstexprWrapAround());
+}
+
+TEST(LinearizeTests, Linearize) {
+    CCircularBuffer<int> buffer(5);
+    ASSERT_TRUE(buffer.is_linearized());
+    ASSERT_TRUE(buffer.linearize().empty());
+
+    for (int i = 1; i <= 8; i++) {
+        buffer.push_back(i);
+    }
+    ASSERT_FALSE(buffer.is_linearized());
+
+    auto span = buffer.linearize();
+    std::vector<int> vector = {4, 5, 6, 7, 8};
+    ASSERT_TRUE(buffer.is_linearized());
+    ASSERT_TRUE(std::equal(span.begin(), span.end(), vector.begin(), vector.end()));
+    ASSERT_TRUE(std::equal(buffer.begin(), buffer.end(), vector.begin(), vector.end()));
+    ASSERT_EQ(buffer.back(), 8);
+
+    buffer.push_back(9);
+    vector = {5, 6, 7, 8, 9};
+    ASSERT_TRUE(std::equal(buffer.begin(), buffer.end(), vector.begin(), vector.end()));
 
+    buffer.pop_front();
+    buffer.pop_front();
+    span = buffer.linearize();
+    std::sort(span.begin(), span.end(), std::greater<>());
+    vector = {9, 8, 7};
+    ASSERT_TRUE(std::equal(buffer.begin(), buffer.end(), vector.begin(), vector.end()));
+}
+
+TEST(LinearizeTests, LinearizeNotTrivial) {
+    CCircularBuffer<std::string> buffer(3);
+    buffer.push_back("a");
+    buffer.push_back("b");
+    buffer.push_back("c");
+    buffer.push_back("d");
+    buffer.pop_front();
+    buffer.push_back("e");
+
+    auto span = buffer.linearize();
+    std::vector<std::string> vector = {"c", "d", "e"};
+    ASSERT_TRUE(std::equal(span.begin(), span.end(), vector.begin(), vector.end()));
+    ASSERT_EQ(buffer.front(), "c");
+    ASSERT_EQ(buffer.back(), "e");
+}
+
+constexpr bool ConstexprLinearize() {
+    CCircularBuffer<int> buffer(4);
+    for (int i = 1; i <= 11; i++) {
+        buffer.push_back(i);
+    }
+
+    auto span = buffer.linearize();
+    return span.size() == 4 && span[0] == 8 && span[3] == 11 && buffer.is_linearized();
+}
+
+TEST(LinearizeTests, Constexpr) {
+    static_assert(ConstexprLinearize());
+}
+
+TEST(ConsumeBatchTests, AcrossWrap) {
+    CCircularBuffer<int> buffer(5);
+    for (int i = 1; i <= 8; i++) {
+        buffer.push_back(i);
+    }
+
+    std::vector<int> consumed;
+    ASSERT_EQ(buffer.consume_batch(3, [&](int value) { consumed.push_back(value); }), 3);
+    std::vector<int> vector = {4, 5, 6};
+    ASSERT_EQ(consumed, vector);
+    ASSERT_EQ(buffer.size(), 2);
+    ASSERT_EQ(buffer.front(), 7);
+
+    buffer.push_back(9);
+    buffer.push_back(10);
+    consumed.clear();
+    ASSERT_EQ(buffer.consume_batch(100, [&](int value) { consumed.push_back(value); }, 1), 4);
+    vector = {7, 8, 9, 10};
+    ASSERT_EQ(consumed, vector);
+    ASSERT_TRUE(buffer.empty());
+    ASSERT_EQ(buffer.consume_batch(100, [&](int value) { consumed.push_back(value); }), 0);
+
+    buffer.push_back(11);
+    ASSERT_EQ(buffer.front(), 11);
+    ASSERT_EQ(buffer.back(), 11);
+}
+
+TEST(ConsumeBatchTests, Projection) {
+    std::vector<std::string> nodes = {"a", "b", "c", "d", "e", "f"};
+    CCircularBuffer<std::string*> buffer(4);
+    for (std::string& node : nodes) {
+        buffer.push_back(&node);
+    }
+
+    std::string joined;
+    size_t projected = 0;
+    size_t count = buffer.consume_batch(4, [&](std::string* node) { joined += *node; }, 2,
+                                        [&](std::string* node) { projected++; return node->data(); });
+
+    ASSERT_EQ(count, 4);
+    ASSERT_EQ(joined, "cdef");
+    ASSERT_EQ(projected, 4);
+    ASSERT_TRUE(buffer.empty());
+
+    buffer.push_back(&nodes[0]);
+    buffer.push_back(&nodes[1]);
+    projected = 0;
+    count = buffer.consume_batch(4, [&](std::string* node) { joined += *node; }, 0,
+                                 [&](std::string* node) { projected++; return node->data(); });
+    ASSERT_EQ(count, 2);
+    ASSERT_EQ(joined, "cdefab");
+    ASSERT_EQ(projected, 0);
+}
+
+constexpr bool ConstexprConsumeBatch() {
+    CCircularBuffer<int> buffer(3);
+    for (int i = 1; i <= 5; i++) {
+        buffer.push_back(i);
+    }
+
+    int sum = 0;
+    size_t count = buffer.consume_batch(2, [&](int value) { sum += value; }, 4, [](int& value) { return &value; });
+
+    return count == 2 && sum == 7 && buffer.size() == 1 && buffer.front() == 5;
+}
+
+TEST(ConsumeBatchTests, Constexpr) {
+    static_assert(ConstexprConsumeBatch());
+}
@@ -0,0 +1,116 @@
+#include "../lib/CCompressedHistory.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+TEST(CompressedHistoryTests, Empty) {
+    CCompressedHistory<int64_t, 4> history(1024);
+
+    ASSERT_TRUE(history.empty());
+    ASSERT_TRUE(history.begin() == history.end());
+    ASSERT_EQ(history.block_count(), 0);
+    ASSERT_THROW((CCompressedHistory<int64_t, 4>(8)), std::invalid_argument);
+}
+
+TEST(CompressedHistoryTests, RoundTrip) {
+    CCompressedHistory<int64_t, 4> history(1024);
+    std::vector<int64_t> vector = {0, 1, -1, 1000, 999, std::numeric_limits<int64_t>::max(),
+                                   std::numeric_limits<int64_t>::min(), 42, 43, 44};
+
+    for (int64_t value : vector) {
+        history.push_back(value);
+    }
+
+    ASSERT_EQ(history.size(), vector.size());
+    ASSERT_EQ(history.block_count(), 3);
+    ASSERT_EQ(history.back(), 44);
+    ASSERT_TRUE(std::equal(history.begin(), history.end(), vector.begin(), vector.end()));
+}
+
+TEST(CompressedHistoryTests, Compression) {
+    CCompressedHistory<int64_t, 64> history(1 << 16);
+    int64_t time = 1'700'000'000'000;
+
+    for (int i = 0; i < 6400; i++) {
+        time += 10 + i % 7;
+        history.push_back(time);
+    }
+
+    ASSERT_EQ(history.size(), 6400);
+    ASSERT_LT(history.bytes_used(), 6400 * 2);
+}
+
+TEST(CompressedHistoryTests, EvictWholeBlocks) {
+    const size_t block = 8;
+    CCompressedHistory<uint32_t, block> history(200);
+
+    for (uint32_t i = 0; i < 1000; i++) {
+        history.push_back(i * 3);
+    }
+
+    ASSERT_EQ(history.size() % block, 0);
+    ASSERT_LE(history.bytes_used(), history.byte_capacity());
+    ASSERT_GE(history.size(), 100);
+
+    uint32_t expected = (1000 - static_cast<uint32_t>(history.size())) * 3;
+    for (uint32_t value : history) {
+        ASSERT_EQ(value, expected);
+        expected += 3;
+    }
+    ASSERT_EQ(expected, 3000);
+
+    history.push_back(1);
+    ASSERT_EQ(history.back(), 1);
+
+    history.clear();
+    ASSERT_TRUE(history.empty());
+    history.push_back(5);
+    ASSERT_EQ(*history.begin(), 5);
+}
+
+TEST(CompressedHistoryTests, VariableBlockLength) {
+    CCompressedHistory<int64_t, 4> history(100);
+    std::vector<int64_t> pushed;
+
+    for (int i = 0; i < 500; i++) {
+        int64_t value = (i % 9 == 0) ? int64_t(1) << (i % 60) : i;
+        history.push_back(value);
+        pushed.push_back(value);
+
+        ASSERT_TRUE(std::equal(history.begin(), history.end(), pushed.end() - history.size(), pushed.end()));
+    }
+}
+
+TEST(CompressedHistoryTests, IteratorConcept) {
+    using Iterator = CCompressedHistory<int64_t>::Iterator;
+    static_assert(std::forward_iterator<Iterator>);
+    static_assert(std::is_same_v<std::iter_reference_t<Iterator>, int64_t>);
+
+    CCompressedHistory<int64_t> history(4096);
+    history.push_back(1);
+    history.push_back(2);
+
+    auto it = history.begin();
+    auto copy = it;
+    int64_t value = *it;
+    ++it;
+    ASSERT_EQ(value, 1);
+    ASSERT_EQ(*copy, 1);
+    ASSERT_EQ(*it, 2);
+}
+
+TEST(CompressedHistoryTests, MemoryUsed) {
+    CCompressedHistory<int64_t, 4> history(1024);
+    for (int64_t i = 0; i < 100; i++) {
+        history.push_back(i);
+    }
+
+    ASSERT_GT(history.index_bytes(), 0);
+    ASSERT_GE(history.memory_used(), history.byte_capacity() + history.index_bytes());
+    ASSERT_GT(history.memory_used(), history.bytes_used() + history.index_bytes());
+}
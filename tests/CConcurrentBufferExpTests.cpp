@@ -0,0 +1,148 @@
+#include "../lib/CConcurrentBufferExp.h"
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <thread>
+#include <vector>
+
+TEST(ConcurrentExpTests, PushPopGrow) {
+    CConcurrentBufferExp<int> buffer(2, 1);
+    ASSERT_TRUE(buffer.empty());
+
+    for (int i = 0; i < 5; i++) {
+        buffer.push_back(i);
+    }
+    ASSERT_EQ(buffer.size(), 5);
+    ASSERT_EQ(buffer.max_size(), 8);
+
+    buffer.pop_front();
+    buffer.pop_front();
+
+    auto guard = buffer.read(0);
+    std::vector<int> vector = {2, 3, 4};
+    ASSERT_TRUE(std::equal(guard.begin(), guard.end(), vector.begin(), vector.end()));
+    ASSERT_EQ(guard[0], 2);
+    ASSERT_EQ(guard.end() - guard.begin(), 3);
+    ASSERT_THROW(buffer.read(1), std::out_of_range);
+}
+
+TEST(ConcurrentExpTests, ReaderKeepsOldStorage) {
+    CConcurrentBufferExp<std::string> buffer(2, 2);
+    buffer.push_back("a");
+    buffer.push_back("b");
+
+    {
+        auto guard = buffer.read(0);
+
+        buffer.push_back("c");
+        buffer.push_back("d");
+        buffer.push_back("e");
+        ASSERT_EQ(buffer.max_size(), 8);
+        ASSERT_EQ(buffer.retired_count(), 2);
+
+        buffer.collect();
+        ASSERT_EQ(buffer.retired_count(), 2);
+
+        ASSERT_EQ(guard.size(), 2);
+        ASSERT_EQ(guard[0], "a");
+        ASSERT_EQ(guard[1], "b");
+
+        auto second = buffer.read(1);
+        ASSERT_EQ(second.size(), 5);
+        ASSERT_EQ(second[4], "e");
+    }
+
+    buffer.collect();
+    ASSERT_EQ(buffer.retired_count(), 0);
+}
+
+TEST(ConcurrentExpTests, PoppedSlotsNotReusedUnderReader) {
+    CConcurrentBufferExp<int> buffer(2, 1);
+    buffer.push_back(1);
+    buffer.push_back(2);
+
+    {
+        auto guard = buffer.read(0);
+        buffer.pop_front();
+        buffer.push_back(3);
+
+        ASSERT_EQ(buffer.max_size(), 4);
+        ASSERT_EQ(guard[0], 1);
+        ASSERT_EQ(guard[1], 2);
+    }
+
+    buffer.pop_front();
+    buffer.push_back(4);
+    buffer.push_back(5);
+    ASSERT_EQ(buffer.max_size(), 4);
+
+    auto guard = buffer.read(0);
+    std::vector<int> vector = {3, 4, 5};
+    ASSERT_TRUE(std::equal(guard.begin(), guard.end(), vector.begin(), vector.end()));
+}
+
+TEST(ConcurrentExpTests, ConcurrentReaders) {
+    const size_t readers = 3;
+    const long long count = 20000;
+    CConcurrentBufferExp<long long> buffer(1, readers);
+
+    std::atomic<bool> done = false;
+    std::vector<char> consistent(readers, 1);
+    std::vector<std::thread> threads;
+
+    for (size_t r = 0; r < readers; r++) {
+        threads.emplace_back([&, r]() {
+            while (!done.load()) {
+                auto guard = buffer.read(r);
+                for (size_t i = 1; i < guard.size(); i++) {
+                    if (guard[i] != guard[i - 1] + 1) {
+                        consistent[r] = 0;
+                    }
+                }
+            }
+        });
+    }
+
+    for (long long i = 0; i < count; i++) {
+        buffer.push_back(i);
+        if (i % 3 == 0) {
+            buffer.pop_front();
+        }
+    }
+
+    done = true;
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    buffer.collect();
+    ASSERT_EQ(buffer.retired_count(), 0);
+    ASSERT_EQ(buffer.size(), count - (count + 2) / 3);
+    for (size_t r = 0; r < readers; r++) {
+        ASSERT_TRUE(consistent[r]);
+    }
+}
+
+TEST(ConcurrentExpTests, BoundedUnderBusyReader) {
+    // The reader is inside a guard at every push and pop, as a reader that
+    // loops on read(0) nearly always is, but keeps taking new ones.
+    CConcurrentBufferExp<int> buffer(64, 1);
+    for (int i = 0; i < 32; i++) {
+        buffer.push_back(i);
+    }
+
+    for (int i = 32; i < 1000000; i += 8) {
+        auto guard = buffer.read(0);
+        ASSERT_EQ(guard.size(), 32);
+        ASSERT_EQ(guard[0], i - 32);
+
+        for (int j = i; j < i + 8; j++) {
+            buffer.pop_front();
+            buffer.push_back(j);
+        }
+    }
+
+    ASSERT_EQ(buffer.size(), 32);
+    ASSERT_LE(buffer.max_size(), 256);
+}
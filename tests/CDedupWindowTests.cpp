@@ -0,0 +1,70 @@
+#include "../lib/CDedupWindow.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <deque>
+#include <string>
+
+TEST(DedupWindowTests, InsertIfAbsent) {
+    CDedupWindow<> window(3);
+    ASSERT_TRUE(window.empty());
+
+    ASSERT_TRUE(window.insert_if_absent(1));
+    ASSERT_TRUE(window.insert_if_absent(2));
+    ASSERT_FALSE(window.insert_if_absent(1));
+    ASSERT_TRUE(window.insert_if_absent(3));
+    ASSERT_EQ(window.size(), 3);
+
+    ASSERT_TRUE(window.insert_if_absent(4));
+    ASSERT_FALSE(window.contains(1));
+    ASSERT_TRUE(window.contains(2));
+    ASSERT_EQ(window.front(), 2);
+    ASSERT_TRUE(window.insert_if_absent(1));
+    ASSERT_FALSE(window.contains(2));
+
+    window.clear();
+    ASSERT_TRUE(window.empty());
+    ASSERT_FALSE(window.contains(4));
+    ASSERT_THROW(CDedupWindow<>(0), std::invalid_argument);
+}
+
+TEST(DedupWindowTests, StringKeys) {
+    CDedupWindow<std::string> window(2);
+    ASSERT_TRUE(window.insert_if_absent("a"));
+    ASSERT_FALSE(window.insert_if_absent("a"));
+    ASSERT_TRUE(window.insert_if_absent("b"));
+    ASSERT_TRUE(window.insert_if_absent("c"));
+    ASSERT_FALSE(window.contains("a"));
+    ASSERT_TRUE(window.contains("c"));
+}
+
+TEST(DedupWindowTests, MatchesLinearScan) {
+    const size_t size = 100;
+    CDedupWindow<uint64_t> window(size);
+    std::deque<uint64_t> model;
+    uint64_t state = 7;
+
+    for (int i = 0; i < 100000; i++) {
+        state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+        uint64_t key = (state >> 33) % 300 * 1024;
+
+        bool absent = std::find(model.begin(), model.end(), key) == model.end();
+        ASSERT_EQ(window.insert_if_absent(key), absent);
+
+        if (absent) {
+            if (model.size() == size) {
+                model.pop_front();
+            }
+            model.push_back(key);
+        }
+
+        ASSERT_EQ(window.size(), model.size());
+        ASSERT_EQ(window.front(), model.front());
+    }
+
+    for (uint64_t key = 0; key < 300 * 1024; key += 1024) {
+        ASSERT_EQ(window.contains(key), std::find(model.begin(), model.end(), key) != model.end());
+    }
+}
@@ -0,0 +1,70 @@
+#include "../lib/CCircularBufferExp.h"
+#include "../lib/CHugePageAllocator.h"
+
+#include <gtest/gtest.h>
+
+#include <string>
+
+TEST(HugePageTests, SmallAllocation) {
+    CCircularBuffer<std::string, CHugePageAllocator<std::string>> buffer(3);
+    buffer.push_back("a");
+    buffer.push_back("b");
+    buffer.push_back("c");
+    buffer.push_back("d");
+
+    std::vector<std::string> vector = {"b", "c", "d"};
+    ASSERT_TRUE(std::equal(buffer.begin(), buffer.end(), vector.begin(), vector.end()));
+}
+
+TEST(HugePageTests, LargeBuffer) {
+    CHugePagePolicy policy;
+    policy.explicit_huge_pages = true;
+    policy.preferred_node = 0;
+    policy.prefault_threads = 4;
+
+    const size_t size = 3 * CHugePagePolicy::kHugePageSize / sizeof(long long);
+    CCircularBuffer<long long, CHugePageAllocator<long long>> buffer(size, CHugePageAllocator<long long>(policy));
+
+    for (size_t i = 0; i < size + 10; i++) {
+        buffer.push_back(static_cast<long long>(i));
+    }
+
+    ASSERT_EQ(buffer.size(), size);
+    ASSERT_EQ(buffer.front(), 10);
+    ASSERT_EQ(buffer.back(), static_cast<long long>(size + 9));
+
+    CCircularBuffer<long long, CHugePageAllocator<long long>> copy(buffer);
+    ASSERT_TRUE(copy == buffer);
+}
+
+TEST(HugePageTests, Growth) {
+    CHugePagePolicy policy;
+    policy.min_size = 1024;
+    policy.prefault_threads = 2;
+
+    CCircularBufferExp<int, CHugePageAllocator<int>> buffer(100, CHugePageAllocator<int>(policy));
+    for (int i = 0; i < 1000; i++) {
+        buffer.push_back(i);
+    }
+
+    ASSERT_EQ(buffer.size(), 1000);
+    ASSERT_EQ(buffer.max_size(), 1600);
+    ASSERT_EQ(buffer[999], 999);
+}
+
+TEST(HugePageTests, Allocator) {
+    CHugePagePolicy policy;
+    policy.min_size = 4096;
+
+    CHugePageAllocator<char> allocator(policy);
+    CHugePageAllocator<int> rebound(allocator);
+    ASSERT_TRUE(allocator == rebound);
+    ASSERT_EQ(rebound.policy().min_size, 4096);
+
+    char* small = allocator.allocate(100);
+    char* large = allocator.allocate(10000);
+    large[9999] = 'x';
+    ASSERT_EQ(large[0], 0);
+    allocator.deallocate(small, 100);
+    allocator.deallocate(large, 10000);
+}
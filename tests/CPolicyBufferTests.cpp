@@ -0,0 +1,153 @@
+#include "../lib/CPolicyBuffer.h"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+TEST(PolicyTests, Overwrite) {
+    CPolicyBuffer<int> buffer(3);
+    for (int i = 1; i <= 5; i++) {
+        ASSERT_TRUE(buffer.push_back(i));
+    }
+
+    std::vector<int> vector = {3, 4, 5};
+    ASSERT_TRUE(std::equal(buffer.begin(), buffer.end(), vector.begin(), vector.end()));
+
+    ASSERT_TRUE(buffer.push_front(2));
+    vector = {2, 3, 4};
+    ASSERT_TRUE(std::equal(buffer.begin(), buffer.end(), vector.begin(), vector.end()));
+
+    buffer.insert(buffer.begin() + 2, 9);
+    vector = {3, 9, 4};
+    ASSERT_TRUE(std::equal(buffer.begin(), buffer.end(), vector.begin(), vector.end()));
+    ASSERT_EQ(buffer.back(), 4);
+}
+
+TEST(PolicyTests, Reject) {
+    CPolicyBuffer<std::string, COverflowPolicy::Reject> buffer(2);
+    ASSERT_TRUE(buffer.push_back("a"));
+    ASSERT_TRUE(buffer.push_front("b"));
+    ASSERT_TRUE(buffer.full());
+
+    ASSERT_FALSE(buffer.push_back("c"));
+    ASSERT_FALSE(buffer.push_front("c"));
+    ASSERT_TRUE(buffer.insert(buffer.begin(), "c") == buffer.end());
+
+    std::vector<std::string> vector = {"b", "a"};
+    ASSERT_TRUE(std::equal(buffer.begin(), buffer.end(), vector.begin(), vector.end()));
+
+    buffer.pop_front();
+    ASSERT_TRUE(buffer.push_back("c"));
+    ASSERT_EQ(buffer.front(), "a");
+    ASSERT_EQ(buffer.back(), "c");
+}
+
+TEST(PolicyTests, Grow) {
+    CPolicyBuffer<int, COverflowPolicy::Grow> buffer;
+    for (int i = 0; i < 10; i++) {
+        ASSERT_TRUE(buffer.push_back(i));
+    }
+    ASSERT_EQ(buffer.size(), 10);
+    ASSERT_EQ(buffer.max_size(), 16);
+
+    buffer.push_front(-1);
+    auto it = buffer.insert(buffer.begin() + 5, 100);
+    ASSERT_EQ(*it, 100);
+    ASSERT_EQ(buffer[0], -1);
+    ASSERT_EQ(buffer[5], 100);
+    ASSERT_EQ(buffer[6], 4);
+    ASSERT_EQ(buffer.back(), 9);
+
+    it = buffer.erase(buffer.begin() + 5);
+    ASSERT_EQ(*it, 4);
+    ASSERT_EQ(buffer.size(), 11);
+
+    CPolicyBuffer<int, COverflowPolicy::Grow> copy(buffer);
+    ASSERT_TRUE(std::equal(copy.begin(), copy.end(), buffer.begin(), buffer.end()));
+}
+
+TEST(PolicyTests, Block) {
+    const int count = 10000;
+    CPolicyBuffer<int, COverflowPolicy::Block> buffer(4);
+
+    bool ordered = true;
+
+    // The consumer pops exactly count elements whatever it sees, so the
+    // producer never blocks forever; the result is checked after join.
+    std::thread consumer([&]() {
+        int expected = 0;
+        int value;
+        while (expected != count) {
+            if (buffer.try_pop_front(value)) {
+                ordered = ordered && value == expected;
+                expected++;
+            }
+        }
+    });
+
+    for (int i = 0; i < count; i++) {
+        EXPECT_TRUE(buffer.push_back(i));
+    }
+
+    consumer.join();
+    ASSERT_TRUE(ordered);
+    ASSERT_TRUE(buffer.empty());
+}
+
+TEST(PolicyTests, BlockInsertWhilePopped) {
+    CPolicyBuffer<int, COverflowPolicy::Block> buffer(3);
+    buffer.push_back(1);
+    buffer.push_back(2);
+    buffer.push_back(3);
+
+    // insert blocks on the full buffer until the consumer pops 1; the
+    // position before 3 must still be before 3 afterwards. The sleep only
+    // makes it likely that insert is already waiting when the pop happens.
+    auto pointer = buffer.begin() + 2;
+    std::thread consumer([&]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        buffer.pop_front();
+    });
+
+    auto it = buffer.insert(pointer, 9);
+    consumer.join();
+
+    std::vector<int> vector = {2, 9, 3};
+    ASSERT_TRUE(std::equal(buffer.begin(), buffer.end(), vector.begin(), vector.end()));
+    ASSERT_EQ(*it, 9);
+
+    // Inserting at end() stays at the end.
+    pointer = buffer.end();
+    consumer = std::thread([&]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        buffer.pop_front();
+    });
+
+    buffer.insert(pointer, 4);
+    consumer.join();
+
+    vector = {9, 3, 4};
+    ASSERT_TRUE(std::equal(buffer.begin(), buffer.end(), vector.begin(), vector.end()));
+}
+
+constexpr bool ConstexprPolicies() {
+    CPolicyBuffer<int> overwrite(2);
+    CPolicyBuffer<int, COverflowPolicy::Reject> reject(2);
+    CPolicyBuffer<int, COverflowPolicy::Grow> grow(1);
+
+    for (int i = 1; i <= 5; i++) {
+        overwrite.push_back(i);
+        reject.push_back(i);
+        grow.push_back(i);
+    }
+
+    return overwrite[0] == 4 && overwrite[1] == 5 && reject.size() == 2 && reject[1] == 2 &&
+           grow.size() == 5 && grow[4] == 5;
+}
+
+TEST(PolicyTests, Constexpr) {
+    static_assert(ConstexprPolicies());
+}
@@ -0,0 +1,125 @@
+#include "../lib/CRecordRing.h"
+
+#include <gtest/gtest.h>
+
+#include <deque>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+    std::string text(std::span<const char> record) {
+        return {record.begin(), record.end()};
+    }
+
+    bool write(CRecordRing& ring, const std::string& value) {
+        return ring.try_write(std::span<const char>(value.data(), value.size()));
+    }
+}
+
+TEST(RecordRingTests, WriteRead) {
+    CRecordRing ring(64);
+    ASSERT_TRUE(ring.empty());
+
+    ASSERT_TRUE(write(ring, "first"));
+    ASSERT_TRUE(write(ring, ""));
+    ASSERT_TRUE(write(ring, "third record"));
+    ASSERT_EQ(ring.size(), 3);
+    ASSERT_EQ(ring.bytes_used(), 12 + 4 + 16);
+
+    ASSERT_EQ(text(ring.read()), "first");
+    ring.pop_front();
+    ASSERT_EQ(ring.read().size(), 0);
+    ring.pop_front();
+    ASSERT_EQ(text(ring.read()), "third record");
+    ring.pop_front();
+
+    ASSERT_TRUE(ring.empty());
+    ASSERT_EQ(ring.bytes_used(), 0);
+}
+
+TEST(RecordRingTests, Full) {
+    CRecordRing ring(30);
+    ASSERT_EQ(ring.max_size(), 32);
+
+    ASSERT_FALSE(write(ring, std::string(29, 'x')));
+    ASSERT_TRUE(write(ring, std::string(12, 'a')));
+    ASSERT_TRUE(write(ring, std::string(12, 'b')));
+    ASSERT_FALSE(write(ring, "c"));
+    ASSERT_EQ(ring.bytes_used(), 32);
+
+    ring.pop_front();
+    ASSERT_TRUE(write(ring, "c"));
+    ASSERT_EQ(text(ring.read()), std::string(12, 'b'));
+}
+
+TEST(RecordRingTests, WrapKeepsRecordsContiguous) {
+    CRecordRing ring(32);
+    ASSERT_TRUE(write(ring, std::string(8, 'a')));
+    ASSERT_TRUE(write(ring, std::string(8, 'b')));
+    ring.pop_front();
+
+    // 8 bytes are left before the end of the array, too few for this record,
+    // so it goes to the front and the tail becomes padding.
+    ASSERT_FALSE(write(ring, std::string(12, 'c')));
+    ASSERT_TRUE(write(ring, std::string(6, 'c')));
+    ASSERT_EQ(ring.bytes_used(), 12 + 8 + 12);
+
+    ring.pop_front();
+    std::span<const char> record = ring.read();
+    ASSERT_EQ(text(record), std::string(6, 'c'));
+    ASSERT_EQ(ring.bytes_used(), 12);
+
+    ASSERT_TRUE(write(ring, std::string(16, 'd')));
+    std::vector<std::string> records;
+    for (std::span<const char> span : ring) {
+        records.push_back(text(span));
+    }
+
+    std::vector<std::string> expected = {std::string(6, 'c'), std::string(16, 'd')};
+    ASSERT_EQ(records, expected);
+}
+
+TEST(RecordRingTests, Consume) {
+    CRecordRing ring(256);
+    for (int i = 0; i < 10; i++) {
+        ASSERT_TRUE(write(ring, std::to_string(i)));
+    }
+
+    std::string seen;
+    ASSERT_EQ(ring.consume(4, [&](std::span<const char> record) { seen += text(record); }), 4);
+    ASSERT_EQ(seen, "0123");
+    ASSERT_EQ(ring.size(), 6);
+
+    ASSERT_EQ(ring.consume(100, [&](std::span<const char> record) { seen += text(record); }), 6);
+    ASSERT_EQ(seen, "0123456789");
+    ASSERT_TRUE(ring.empty());
+}
+
+TEST(RecordRingTests, RandomAgainstDeque) {
+    CRecordRing ring(1000);
+    std::deque<std::string> model;
+    std::mt19937 random(42);
+
+    for (int step = 0; step < 100000; step++) {
+        if (random() % 2 == 0) {
+            std::string value(random() % 120, static_cast<char>('a' + step % 26));
+
+            if (write(ring, value)) {
+                model.push_back(value);
+            } else {
+                ASSERT_FALSE(model.empty());
+            }
+        } else if (!model.empty()) {
+            ASSERT_EQ(text(ring.read()), model.front());
+            ring.pop_front();
+            model.pop_front();
+        }
+
+        ASSERT_EQ(ring.size(), model.size());
+        ASSERT_LE(ring.bytes_used(), ring.max_size());
+    }
+
+    ASSERT_TRUE(std::equal(ring.begin(), ring.end(), model.begin(), model.end(),
+                           [](std::span<const char> record, const std::string& value) { return text(record) == value; }));
+}
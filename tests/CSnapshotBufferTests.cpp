@@ -0,0 +1,128 @@
+#include "../lib/CSnapshotBuffer.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <string>
+#include <thread>
+#include <vector>
+
+TEST(SnapshotTests, PushPop) {
+    CSnapshotBuffer<int, 2> buffer(3);
+    ASSERT_TRUE(buffer.empty());
+
+    buffer.push_back(1);
+    buffer.push_back(2);
+    buffer.push_back(3);
+    buffer.push_back(4);
+    ASSERT_EQ(buffer.size(), 3);
+    ASSERT_EQ(buffer.front(), 2);
+    ASSERT_EQ(buffer.back(), 4);
+
+    buffer.push_front(0);
+    std::vector<int> vector = {0, 2, 3};
+    ASSERT_TRUE(std::equal(buffer.begin(), buffer.end(), vector.begin(), vector.end()));
+
+    buffer.pop_front();
+    buffer.pop_back();
+    ASSERT_EQ(buffer.size(), 1);
+    ASSERT_EQ(buffer.front(), 2);
+
+    buffer.set(0, 7);
+    ASSERT_EQ(buffer[0], 7);
+    ASSERT_THROW(buffer.set(1, 0), std::out_of_range);
+}
+
+TEST(SnapshotTests, SnapshotIsStable) {
+    CSnapshotBuffer<int, 4> buffer(10);
+    for (int i = 0; i < 10; i++) {
+        buffer.push_back(i);
+    }
+
+    auto snapshot = buffer.snapshot();
+
+    for (int i = 10; i < 25; i++) {
+        buffer.push_back(i);
+    }
+    buffer.set(0, -1);
+
+    std::vector<int> vector = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
+    ASSERT_EQ(snapshot.size(), 10);
+    ASSERT_TRUE(std::equal(snapshot.begin(), snapshot.end(), vector.begin(), vector.end()));
+
+    vector = {-1, 16, 17, 18, 19, 20, 21, 22, 23, 24};
+    ASSERT_TRUE(std::equal(buffer.begin(), buffer.end(), vector.begin(), vector.end()));
+}
+
+TEST(SnapshotTests, SeveralSnapshots) {
+    CSnapshotBuffer<std::string, 2> buffer(4);
+    buffer.push_back("a");
+    buffer.push_back("b");
+
+    auto first = buffer.snapshot();
+    buffer.push_back("c");
+    auto second = buffer.snapshot();
+    buffer.pop_front();
+    buffer.set(0, "x");
+    auto copy = buffer;
+    buffer.push_back("d");
+
+    ASSERT_EQ(first.size(), 2);
+    ASSERT_EQ(first.back(), "b");
+    ASSERT_EQ(second.size(), 3);
+    ASSERT_EQ(second[0], "a");
+    ASSERT_EQ(second[2], "c");
+    ASSERT_EQ(copy.size(), 2);
+    ASSERT_EQ(copy.front(), "x");
+    ASSERT_EQ(buffer.back(), "d");
+}
+
+TEST(SnapshotTests, SnapshotIterator) {
+    CSnapshotBuffer<int, 3> buffer(6);
+    for (int value : {5, 3, 8, 1, 9, 2, 7}) {
+        buffer.push_back(value);
+    }
+
+    auto snapshot = buffer.snapshot();
+    ASSERT_EQ(snapshot.end() - snapshot.begin(), 6);
+    ASSERT_EQ(*std::max_element(snapshot.begin(), snapshot.end()), 9);
+    ASSERT_EQ(std::lower_bound(snapshot.begin(), snapshot.begin() + 2, 5) - snapshot.begin(), 1);
+    ASSERT_EQ(snapshot.begin()[4], 2);
+    ASSERT_TRUE(snapshot.begin() < snapshot.end());
+
+    std::vector<int> vector(snapshot.begin(), snapshot.end());
+    ASSERT_EQ(vector, std::vector<int>({3, 8, 1, 9, 2, 7}));
+}
+
+TEST(SnapshotTests, ConcurrentReaders) {
+    CSnapshotBuffer<int, 16> buffer(256);
+    for (int i = 0; i < 256; i++) {
+        buffer.push_back(i);
+    }
+
+    std::vector<std::thread> readers;
+    std::vector<char> consistent(4, 1);
+
+    for (int r = 0; r < 4; r++) {
+        auto snapshot = buffer.snapshot();
+        readers.emplace_back([snapshot, r, &consistent]() {
+            for (int pass = 0; pass < 100; pass++) {
+                for (size_t i = 1; i < snapshot.size(); i++) {
+                    if (snapshot[i] != snapshot[i - 1] + 1) {
+                        consistent[r] = 0;
+                    }
+                }
+            }
+        });
+
+        for (int i = 0; i < 1000; i++) {
+            buffer.push_back(buffer.back() + 1);
+        }
+    }
+
+    for (auto& reader : readers) {
+        reader.join();
+    }
+
+    ASSERT_TRUE(std::all_of(consistent.begin(), consistent.end(), [](char value) { return value != 0; }));
+}
@@ -0,0 +1,124 @@
+#include "../lib/CTimeSeriesBuffer.h"
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+struct Sample {
+    long long time;
+    int value;
+};
+
+static std::vector<int> collect(const CTimeSeriesBuffer<int>::Segments& segments) {
+    std::vector<int> result(segments.first.begin(), segments.first.end());
+    result.insert(result.end(), segments.second.begin(), segments.second.end());
+    return result;
+}
+
+TEST(TimeSeriesTests, RangeNoWrap) {
+    CTimeSeriesBuffer<int> buffer(5);
+    buffer.push_back(1);
+    buffer.push_back(3);
+    buffer.push_back(5);
+    buffer.push_back(7);
+
+    auto segments = buffer.range(2, 7);
+    ASSERT_TRUE(segments.second.empty());
+    ASSERT_EQ(collect(segments), std::vector<int>({3, 5}));
+
+    ASSERT_TRUE(collect(buffer.range(8, 10)).empty());
+    ASSERT_TRUE(collect(buffer.range(5, 2)).empty());
+    ASSERT_EQ(collect(buffer.range(0, 100)), std::vector<int>({1, 3, 5, 7}));
+}
+
+TEST(TimeSeriesTests, RangeWrap) {
+    CTimeSeriesBuffer<int> buffer(4);
+    for (int i = 1; i <= 7; i++) {
+        buffer.push_back(i * 10);
+    }
+
+    ASSERT_EQ(collect(buffer.segments()), std::vector<int>({40, 50, 60, 70}));
+
+    auto segments = buffer.range(45, 70);
+    ASSERT_EQ(collect(segments), std::vector<int>({50, 60}));
+
+    segments = buffer.range(40, 71);
+    ASSERT_FALSE(segments.second.empty());
+    ASSERT_EQ(collect(segments), std::vector<int>({40, 50, 60, 70}));
+
+    ASSERT_EQ(collect(buffer.range(60, 80)), std::vector<int>({60, 70}));
+}
+
+TEST(TimeSeriesTests, EvictBefore) {
+    CTimeSeriesBuffer<int> buffer(4);
+    for (int i = 1; i <= 6; i++) {
+        buffer.push_back(i);
+    }
+
+    ASSERT_EQ(buffer.evict_before(0), 0);
+    ASSERT_EQ(buffer.evict_before(5), 2);
+    ASSERT_EQ(buffer.size(), 2);
+    ASSERT_EQ(buffer.front(), 5);
+
+    std::vector<int> vector = {5, 6};
+    ASSERT_TRUE(std::equal(buffer.begin(), buffer.end(), vector.begin(), vector.end()));
+
+    buffer.push_back(7);
+    buffer.push_back(8);
+    buffer.push_back(9);
+    ASSERT_EQ(buffer.evict_before(100), 4);
+    ASSERT_TRUE(buffer.empty());
+}
+
+TEST(TimeSeriesTests, Projection) {
+    CTimeSeriesBuffer<Sample, long long Sample::*> buffer(3, &Sample::time);
+    buffer.push_back({100, 1});
+    buffer.push_back({200, 2});
+    buffer.push_back({300, 3});
+    buffer.push_back({400, 4});
+
+    auto segments = buffer.range(200, 400);
+    ASSERT_EQ(segments.first.size() + segments.second.size(), 2);
+    ASSERT_EQ(segments.first[0].value, 2);
+
+    ASSERT_EQ(buffer.evict_before(350), 2);
+    ASSERT_EQ(buffer.front().value, 4);
+}
+
+TEST(TimeSeriesTests, OrderViolation) {
+    CTimeSeriesBuffer<int> buffer(3);
+    buffer.push_back(5);
+    buffer.push_back(5);
+
+    ASSERT_THROW(buffer.push_back(4), std::invalid_argument);
+    ASSERT_THROW(buffer.push_front(6), std::invalid_argument);
+
+    buffer.push_front(1);
+    ASSERT_EQ(buffer.front(), 1);
+}
+
+TEST(TimeSeriesTests, InsertOrderViolation) {
+    CTimeSeriesBuffer<int> buffer(5);
+    buffer.push_back(1);
+    buffer.push_back(5);
+    buffer.push_back(9);
+
+    auto pointer = buffer.begin() + 1;
+    ASSERT_THROW(buffer.insert(pointer, 100), std::invalid_argument);
+    ASSERT_THROW(buffer.insert(pointer, 0), std::invalid_argument);
+
+    auto first = buffer.begin();
+    ASSERT_THROW(buffer.insert(first, 2), std::invalid_argument);
+
+    std::vector<int> vector = {1, 5, 9};
+    ASSERT_TRUE(std::equal(buffer.begin(), buffer.end(), vector.begin(), vector.end()));
+
+    buffer.insert(pointer, 3);
+    auto last = buffer.end();
+    buffer.insert(last, 9);
+    vector = {1, 3, 5, 9, 9};
+    ASSERT_TRUE(std::equal(buffer.begin(), buffer.end(), vector.begin(), vector.end()));
+
+    auto [first_span, second_span] = buffer.range(0, 10);
+    ASSERT_EQ(first_span.size() + second_span.size(), 5);
+}